@@ -0,0 +1,688 @@
+#ifndef BTREE_H
+#define BTREE_H
+#include<memory>
+#include<initializer_list>
+#include<iterator>
+#include<type_traits>
+#include<utility>
+#include<cstring>
+
+//values per node so that a leaf stays close to NodeBytes, never fewer than three
+template<typename Value, size_t NodeBytes>
+struct btree_slots {
+	static const size_t _fit = (NodeBytes - 2 * sizeof(void*)) / sizeof(Value);
+	static const size_t value = _fit < 3 ? 3 : _fit;
+};
+
+template<typename Value, size_t N>
+struct btree_node {
+	btree_node *_parent;
+	//index of this node in _parent's children
+	unsigned short _position;
+	unsigned short _count;
+	bool _leaf;
+	typename std::aligned_storage<sizeof(Value), alignof(Value)>::type _slots[N];
+
+	Value* _data() {
+		return reinterpret_cast<Value*>(_slots);
+	}
+
+	const Value* _data()const {
+		return reinterpret_cast<const Value*>(_slots);
+	}
+
+	btree_node*& _child(size_t i);
+};
+
+//only internal nodes pay for the child pointers
+template<typename Value, size_t N>
+struct btree_internal_node :public btree_node<Value, N> {
+	btree_node<Value, N> *_children[N + 1];
+};
+
+template<typename Value, size_t N>
+btree_node<Value, N>*& btree_node<Value, N>::_child(size_t i) {
+	return static_cast<btree_internal_node<Value, N>*>(this)->_children[i];
+}
+
+template<typename Value, typename Ref, typename Ptr, size_t N>
+class btree_iterator {
+public:
+	typedef Value                           value_type;
+	typedef Ref                             reference;
+	typedef Ptr                             pointer;
+	typedef ptrdiff_t                       difference_type;
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef btree_node<Value, N>*           link_type;
+protected:
+	link_type _node;
+	int _pos;
+public:
+	btree_iterator() :_node(nullptr), _pos(0) {};
+
+	btree_iterator(link_type node, int pos) :_node(node), _pos(pos) {};
+
+	btree_iterator(const btree_iterator &x) :_node(x._node), _pos(x._pos) {};
+
+	btree_iterator& operator=(const btree_iterator &x) {
+		_node = x._node;
+		_pos = x._pos;
+		return *this;
+	}
+
+	bool operator==(const btree_iterator &x)const {
+		return _node == x._node && _pos == x._pos;
+	}
+
+	bool operator!=(const btree_iterator &x)const {
+		return !(*this == x);
+	}
+
+	reference operator*()const {
+		return _node->_data()[_pos];
+	}
+
+	pointer operator->()const {
+		return _node->_data() + _pos;
+	}
+
+	btree_iterator& operator++() {
+		if (!_node->_leaf) {
+			_node = _node->_child(_pos + 1);
+			while (!_node->_leaf)
+				_node = _node->_child(0);
+			_pos = 0;
+			return *this;
+		}
+		if (++_pos < _node->_count)
+			return *this;
+		//climb out of last children; past the last value the iterator stays at (rightmost leaf, count), which is end()
+		link_type node = _node;
+		int pos = _pos;
+		while (pos == node->_count && node->_parent) {
+			pos = node->_position;
+			node = node->_parent;
+		}
+		if (pos < node->_count) {
+			_node = node;
+			_pos = pos;
+		}
+		return *this;
+	}
+
+	btree_iterator operator++(int) {
+		btree_iterator ret(*this);
+		++*this;
+		return ret;
+	}
+
+	btree_iterator& operator--() {
+		if (!_node->_leaf) {
+			_node = _node->_child(_pos);
+			while (!_node->_leaf)
+				_node = _node->_child(_node->_count);
+			_pos = _node->_count - 1;
+			return *this;
+		}
+		if (--_pos >= 0)
+			return *this;
+		link_type node = _node;
+		int pos = _pos;
+		while (pos < 0 && node->_parent) {
+			pos = node->_position - 1;
+			node = node->_parent;
+		}
+		if (pos >= 0) {
+			_node = node;
+			_pos = pos;
+		}
+		return *this;
+	}
+
+	btree_iterator operator--(int) {
+		btree_iterator ret(*this);
+		--*this;
+		return ret;
+	}
+
+	link_type _Node()const {
+		return _node;
+	}
+
+	int _Pos()const {
+		return _pos;
+	}
+};
+
+template<typename Value, typename Ref, typename Ptr, size_t N>
+class const_btree_iterator :public btree_iterator<Value, Ref, Ptr, N> {
+public:
+	typedef Value                              value_type;
+	typedef Ref                                reference;
+	typedef Ptr                                pointer;
+	typedef ptrdiff_t                          difference_type;
+	typedef std::bidirectional_iterator_tag    iterator_category;
+	typedef btree_node<Value, N>*              link_type;
+	typedef btree_iterator<Value, Ref, Ptr, N> parent_iterator;
+
+	const_btree_iterator() :parent_iterator() {};
+
+	const_btree_iterator(const parent_iterator &x) :parent_iterator(x) {};
+
+	const_btree_iterator& operator=(const parent_iterator &x) {
+		parent_iterator::operator=(x);
+		return *this;
+	}
+
+	const Value& operator*()const {
+		return this->_node->_data()[this->_pos];
+	}
+
+	const Value* operator->()const {
+		return this->_node->_data() + this->_pos;
+	}
+
+	const_btree_iterator& operator++() {
+		parent_iterator::operator++();
+		return *this;
+	}
+
+	const_btree_iterator operator++(int) {
+		const_btree_iterator ret(*this);
+		++*this;
+		return ret;
+	}
+
+	const_btree_iterator& operator--() {
+		parent_iterator::operator--();
+		return *this;
+	}
+
+	const_btree_iterator operator--(int) {
+		const_btree_iterator ret(*this);
+		--*this;
+		return ret;
+	}
+};
+
+//B-tree with unique keys and values in every node. A leaf holds btree_slots<Value, NodeBytes>::value values, an internal
+//node adds one child pointer per value, so a lookup touches log_B(n) nodes instead of log_2(n).
+//Inserts and erases invalidate iterators.
+template<typename Key, typename Value, typename KeyOfValue, typename Compare, size_t NodeBytes = 256>
+class BTree {
+public:
+	typedef Key                                                key_type;
+	typedef Value                                              value_type;
+	typedef size_t                                             size_type;
+	typedef Value&                                             reference;
+	typedef Value*                                             pointer;
+	static const size_type slots = btree_slots<Value, NodeBytes>::value;
+	typedef btree_node<Value, slots>                           node_type;
+	typedef btree_internal_node<Value, slots>                  internal_node_type;
+	typedef node_type*                                         link_type;
+	typedef btree_iterator<Value, Value&, Value*, slots>       iterator;
+private:
+	//a non-root node never drops below this, so a node that underflows can always merge with a sibling
+	static const size_type _minCount = (slots - 1) / 2;
+
+	link_type _root;
+	link_type _leftmost;
+	link_type _rightmost;
+	size_type _size;
+	Compare _keyCompare;
+	KeyOfValue _keyOfValue;
+	std::allocator<node_type> _leafAlloc;
+	std::allocator<internal_node_type> _internalAlloc;
+public:
+	explicit BTree(const Compare &compare) :_root(nullptr), _leftmost(nullptr), _rightmost(nullptr), _size(0), _keyCompare(compare), _keyOfValue() {};
+
+	template<typename InputIterator>
+	BTree(InputIterator first, InputIterator last, const Compare &compare) :_root(nullptr), _leftmost(nullptr), _rightmost(nullptr), _size(0), _keyCompare(compare), _keyOfValue() {
+		insert_unique(first, last);
+	};
+
+	BTree(const BTree &x) :_root(nullptr), _leftmost(nullptr), _rightmost(nullptr), _size(0), _keyCompare(x._keyCompare), _keyOfValue() {
+		_copy_from(x);
+	};
+
+	BTree(std::initializer_list<value_type> il, const Compare &compare) :_root(nullptr), _leftmost(nullptr), _rightmost(nullptr), _size(0), _keyCompare(compare), _keyOfValue() {
+		insert_unique(il.begin(), il.end());
+	};
+
+	~BTree() {
+		clear();
+	}
+
+	void assign(const BTree &x) {
+		if (this == &x)
+			return;
+		clear();
+		_copy_from(x);
+	}
+
+	void assign(std::initializer_list<value_type> il) {
+		clear();
+		insert_unique(il.begin(), il.end());
+	}
+
+	iterator begin()const {
+		return _root ? iterator(_leftmost, 0) : iterator();
+	}
+
+	iterator end()const {
+		return _root ? iterator(_rightmost, _rightmost->_count) : iterator();
+	}
+
+	size_type size()const {
+		return _size;
+	}
+
+	bool empty()const {
+		return _size == 0;
+	}
+
+	std::pair<iterator, bool> insert_unique(const value_type &x) {
+		if (!_root) {
+			_root = _leftmost = _rightmost = _new_node(true);
+			::new((void*)_root->_data()) value_type(x);
+			_root->_count = 1;
+			_size = 1;
+			return std::pair<iterator, bool>(iterator(_root, 0), true);
+		}
+		if (_root->_count == slots) {
+			link_type newRoot = _new_node(false);
+			_set_child(newRoot, 0, _root);
+			_root = newRoot;
+			_split_child(newRoot, 0);
+		}
+		//full children are split on the way down, so the leaf always has room
+		link_type node = _root;
+		while (true) {
+			size_type i = _lower_index(node, _keyOfValue(x));
+			if (i < node->_count && !_keyCompare(_keyOfValue(x), _keyOfValue(node->_data()[i])))
+				return std::pair<iterator, bool>(iterator(node, i), false);
+			if (node->_leaf) {
+				_move_values(node, i + 1, node, i, node->_count - i);
+				::new((void*)(node->_data() + i)) value_type(x);
+				++node->_count;
+				++_size;
+				return std::pair<iterator, bool>(iterator(node, i), true);
+			}
+			if (node->_child(i)->_count == slots) {
+				_split_child(node, i);
+				if (_keyCompare(_keyOfValue(node->_data()[i]), _keyOfValue(x)))
+					++i;
+				else if (!_keyCompare(_keyOfValue(x), _keyOfValue(node->_data()[i])))
+					return std::pair<iterator, bool>(iterator(node, i), false);
+			}
+			node = node->_child(i);
+		}
+	}
+
+	//a descent is only log_B(n) nodes, so the hint is not used
+	iterator insert_unique(iterator position, const value_type &x) {
+		return insert_unique(x).first;
+	}
+
+	template<typename InputIterator>
+	void insert_unique(InputIterator first, InputIterator last) {
+		while (first != last) {
+			insert_unique(*first);
+			++first;
+		}
+	}
+
+	iterator erase(iterator position) {
+		iterator next = position;
+		++next;
+		if (next == end()) {
+			_erase_at(position._Node(), position._Pos());
+			return end();
+		}
+		//values move between nodes while rebalancing, so the successor is looked up again by key
+		key_type nextKey = _keyOfValue(*next);
+		_erase_at(position._Node(), position._Pos());
+		return _lower_bound(nextKey);
+	}
+
+	iterator erase(iterator first, iterator last) {
+		if (first == begin() && last == end()) {
+			clear();
+			return end();
+		}
+		size_type n = std::distance(first, last);
+		while (n--)
+			first = erase(first);
+		return first;
+	}
+
+	size_type erase(const key_type &k) {
+		iterator it = _find(k);
+		if (it == end())
+			return 0;
+		_erase_at(it._Node(), it._Pos());
+		return 1;
+	}
+
+	void clear() {
+		if (!_root)
+			return;
+		_destroy_subtree(_root);
+		_root = _leftmost = _rightmost = nullptr;
+		_size = 0;
+	}
+
+	void swap(BTree &x) {
+		std::swap(_root, x._root);
+		std::swap(_leftmost, x._leftmost);
+		std::swap(_rightmost, x._rightmost);
+		std::swap(_size, x._size);
+		std::swap(_keyCompare, x._keyCompare);
+	}
+
+	iterator find(const key_type &k)const {
+		return _find(k);
+	}
+
+	iterator lower_bound(const key_type &k)const {
+		return _lower_bound(k);
+	}
+
+	iterator upper_bound(const key_type &k)const {
+		return _upper_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &k)const {
+		return _find(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &k)const {
+		return _lower_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &k)const {
+		return _upper_bound(k);
+	}
+private:
+	link_type _new_node(bool leaf) {
+		link_type node = leaf ? _leafAlloc.allocate(1) : _internalAlloc.allocate(1);
+		node->_parent = nullptr;
+		node->_position = 0;
+		node->_count = 0;
+		node->_leaf = leaf;
+		return node;
+	}
+
+	void _delete_node(link_type node) {
+		if (node->_leaf)
+			_leafAlloc.deallocate(node, 1);
+		else
+			_internalAlloc.deallocate(static_cast<internal_node_type*>(node), 1);
+	}
+
+	void _destroy_subtree(link_type node) {
+		pointer data = node->_data();
+		for (size_type i = 0; i < node->_count; ++i)
+			data[i].~value_type();
+		if (!node->_leaf) {
+			for (size_type i = 0; i <= node->_count; ++i)
+				_destroy_subtree(node->_child(i));
+		}
+		_delete_node(node);
+	}
+
+	void _copy_from(const BTree &x) {
+		if (!x._root)
+			return;
+		_root = _clone(x._root, nullptr, 0);
+		_leftmost = _rightmost = _root;
+		while (!_leftmost->_leaf)
+			_leftmost = _leftmost->_child(0);
+		while (!_rightmost->_leaf)
+			_rightmost = _rightmost->_child(_rightmost->_count);
+		_size = x._size;
+	}
+
+	link_type _clone(link_type x, link_type parent, size_type position) {
+		link_type node = _new_node(x->_leaf);
+		node->_parent = parent;
+		node->_position = position;
+		node->_count = x->_count;
+		std::uninitialized_copy(x->_data(), x->_data() + x->_count, node->_data());
+		if (!x->_leaf) {
+			for (size_type i = 0; i <= x->_count; ++i)
+				node->_child(i) = _clone(x->_child(i), node, i);
+		}
+		return node;
+	}
+
+	void _set_child(link_type parent, size_type i, link_type child) {
+		parent->_child(i) = child;
+		child->_parent = parent;
+		child->_position = i;
+	}
+
+	//Branchless search inside a node: the range halves every step and the comparison only selects the next base.
+	//Returns the first slot whose key is not less than k.
+	template<typename K>
+	size_type _lower_index(link_type node, const K &k)const {
+		size_type n = node->_count;
+		if (n == 0)
+			return 0;
+		const Value *data = node->_data();
+		size_type lo = 0;
+		while (n > 1) {
+			size_type half = n / 2;
+			lo = _keyCompare(_keyOfValue(data[lo + half]), k) ? lo + half : lo;
+			n -= half;
+		}
+		return lo + _keyCompare(_keyOfValue(data[lo]), k);
+	}
+
+	//first slot whose key is greater than k
+	template<typename K>
+	size_type _upper_index(link_type node, const K &k)const {
+		size_type n = node->_count;
+		if (n == 0)
+			return 0;
+		const Value *data = node->_data();
+		size_type lo = 0;
+		while (n > 1) {
+			size_type half = n / 2;
+			lo = _keyCompare(k, _keyOfValue(data[lo + half])) ? lo : lo + half;
+			n -= half;
+		}
+		return lo + !_keyCompare(k, _keyOfValue(data[lo]));
+	}
+
+	//always descends to a leaf, the last candidate seen on the way is the answer
+	template<typename K>
+	iterator _lower_bound(const K &k)const {
+		iterator res = end();
+		link_type node = _root;
+		while (node) {
+			size_type i = _lower_index(node, k);
+			if (i < node->_count)
+				res = iterator(node, i);
+			if (node->_leaf)
+				break;
+			node = node->_child(i);
+		}
+		return res;
+	}
+
+	template<typename K>
+	iterator _upper_bound(const K &k)const {
+		iterator res = end();
+		link_type node = _root;
+		while (node) {
+			size_type i = _upper_index(node, k);
+			if (i < node->_count)
+				res = iterator(node, i);
+			if (node->_leaf)
+				break;
+			node = node->_child(i);
+		}
+		return res;
+	}
+
+	template<typename K>
+	iterator _find(const K &k)const {
+		iterator res = _lower_bound(k);
+		if (res == end() || _keyCompare(k, _keyOfValue(*res)))
+			return end();
+		return res;
+	}
+
+	void _move_values(link_type dst, size_type to, link_type src, size_type from, size_type n) {
+		_move_values_aux(dst, to, src, from, n, std::integral_constant<bool, std::is_trivially_copyable<value_type>::value>());
+	}
+
+	void _move_values_aux(link_type dst, size_type to, link_type src, size_type from, size_type n, std::true_type) {
+		if (n)
+			std::memmove((void*)(dst->_data() + to), (const void*)(src->_data() + from), n * sizeof(value_type));
+	}
+
+	//move-constructs into the target slots and destroys the sources, back to front when shifting right within a node
+	void _move_values_aux(link_type dst, size_type to, link_type src, size_type from, size_type n, std::false_type) {
+		pointer dstData = dst->_data();
+		pointer srcData = src->_data();
+		if (dst == src && to > from) {
+			for (size_type i = n; i > 0; --i) {
+				::new((void*)(dstData + to + i - 1)) value_type(std::move(srcData[from + i - 1]));
+				srcData[from + i - 1].~value_type();
+			}
+		}
+		else {
+			for (size_type i = 0; i < n; ++i) {
+				::new((void*)(dstData + to + i)) value_type(std::move(srcData[from + i]));
+				srcData[from + i].~value_type();
+			}
+		}
+	}
+
+	//child i of parent is full: its upper half moves to a new right sibling and the median moves up into parent
+	void _split_child(link_type parent, size_type i) {
+		link_type child = parent->_child(i);
+		link_type sibling = _new_node(child->_leaf);
+		size_type mid = slots / 2;
+		size_type moved = slots - mid - 1;
+		_move_values(sibling, 0, child, mid + 1, moved);
+		if (!child->_leaf) {
+			for (size_type j = 0; j <= moved; ++j)
+				_set_child(sibling, j, child->_child(mid + 1 + j));
+		}
+		sibling->_count = moved;
+		_move_values(parent, i + 1, parent, i, parent->_count - i);
+		for (size_type j = parent->_count; j > i; --j)
+			_set_child(parent, j + 1, parent->_child(j));
+		_move_values(parent, i, child, mid, 1);
+		child->_count = mid;
+		_set_child(parent, i + 1, sibling);
+		++parent->_count;
+		if (child == _rightmost)
+			_rightmost = sibling;
+	}
+
+	//a value in an internal node is replaced by its predecessor, so the removal itself always happens in a leaf
+	void _erase_at(link_type node, size_type pos) {
+		node->_data()[pos].~value_type();
+		if (!node->_leaf) {
+			link_type pred = node->_child(pos);
+			while (!pred->_leaf)
+				pred = pred->_child(pred->_count);
+			_move_values(node, pos, pred, pred->_count - 1, 1);
+			node = pred;
+		}
+		else
+			_move_values(node, pos, node, pos + 1, node->_count - pos - 1);
+		--node->_count;
+		--_size;
+		_rebalance_erase(node);
+	}
+
+	//borrows from a sibling with spare values, otherwise merges and carries the underflow to the parent
+	void _rebalance_erase(link_type node) {
+		while (node != _root && node->_count < _minCount) {
+			link_type parent = node->_parent;
+			size_type i = node->_position;
+			if (i > 0 && parent->_child(i - 1)->_count > _minCount) {
+				_rotate_right(parent, i - 1);
+				return;
+			}
+			if (i < parent->_count && parent->_child(i + 1)->_count > _minCount) {
+				_rotate_left(parent, i);
+				return;
+			}
+			_merge(parent, i > 0 ? i - 1 : i);
+			node = parent;
+		}
+		if (_root->_count == 0) {
+			link_type oldRoot = _root;
+			if (oldRoot->_leaf)
+				_root = _leftmost = _rightmost = nullptr;
+			else {
+				_root = oldRoot->_child(0);
+				_root->_parent = nullptr;
+				_root->_position = 0;
+			}
+			_delete_node(oldRoot);
+		}
+	}
+
+	//the last value of child i goes up into separator i, which comes down to the front of child i + 1
+	void _rotate_right(link_type parent, size_type i) {
+		link_type left = parent->_child(i);
+		link_type right = parent->_child(i + 1);
+		_move_values(right, 1, right, 0, right->_count);
+		_move_values(right, 0, parent, i, 1);
+		_move_values(parent, i, left, left->_count - 1, 1);
+		if (!right->_leaf) {
+			for (size_type j = right->_count + 1; j > 0; --j)
+				_set_child(right, j, right->_child(j - 1));
+			_set_child(right, 0, left->_child(left->_count));
+		}
+		--left->_count;
+		++right->_count;
+	}
+
+	void _rotate_left(link_type parent, size_type i) {
+		link_type left = parent->_child(i);
+		link_type right = parent->_child(i + 1);
+		_move_values(left, left->_count, parent, i, 1);
+		_move_values(parent, i, right, 0, 1);
+		_move_values(right, 0, right, 1, right->_count - 1);
+		if (!right->_leaf) {
+			_set_child(left, left->_count + 1, right->_child(0));
+			for (size_type j = 0; j < right->_count; ++j)
+				_set_child(right, j, right->_child(j + 1));
+		}
+		++left->_count;
+		--right->_count;
+	}
+
+	//child i, separator i and child i + 1 become one node
+	void _merge(link_type parent, size_type i) {
+		link_type left = parent->_child(i);
+		link_type right = parent->_child(i + 1);
+		_move_values(left, left->_count, parent, i, 1);
+		_move_values(left, left->_count + 1, right, 0, right->_count);
+		if (!left->_leaf) {
+			for (size_type j = 0; j <= right->_count; ++j)
+				_set_child(left, left->_count + 1 + j, right->_child(j));
+		}
+		left->_count += right->_count + 1;
+		_move_values(parent, i, parent, i + 1, parent->_count - i - 1);
+		for (size_type j = i + 1; j < parent->_count; ++j)
+			_set_child(parent, j, parent->_child(j + 1));
+		--parent->_count;
+		if (right == _rightmost)
+			_rightmost = left;
+		_delete_node(right);
+	}
+};
+
+#endif // !BTREE_H
\ No newline at end of file
@@ -0,0 +1,193 @@
+#ifndef BTREEMAP_H
+#define BTREEMAP_H
+#include"BTree.h"
+#include"Map.h"
+
+//Map interface over a B-tree with wide nodes, see BTree. Inserts and erases invalidate iterators.
+template<typename Key, typename T, typename Compare = std::less<Key>, size_t NodeBytes = 256>
+class BTreeMap {
+public:
+	typedef Key                                                                          key_type;
+	typedef T                                                                            mapped_type;
+	typedef std::pair<const Key, T>                                                      value_type;
+	typedef Compare                                                                      key_compare;
+	typedef value_type&                                                                  reference;
+	typedef const value_type&                                                            const_reference;
+	typedef value_type*                                                                  pointer;
+	typedef const value_type*                                                            const_pointer;
+	typedef BTree<Key, value_type, select1st<const Key, T>, Compare, NodeBytes>          tree_type;
+	typedef typename tree_type::iterator                                                 iterator;
+	typedef const_btree_iterator<value_type, value_type&, value_type*, tree_type::slots> const_iterator;
+	typedef std::reverse_iterator<iterator>                                              reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>                                        const_reverse_iterator;
+	typedef ptrdiff_t                                                                    difference_type;
+	typedef size_t                                                                       size_type;
+private:
+	tree_type _tree;
+public:
+	explicit BTreeMap(const key_compare &comp = key_compare()) :_tree(comp) {};
+
+	template<typename InputIterator>
+	BTreeMap(InputIterator first, InputIterator last, const key_compare &comp = key_compare()) :_tree(first, last, comp) {};
+
+	BTreeMap(const BTreeMap &x) :_tree(x._tree) {};
+
+	BTreeMap(std::initializer_list<value_type> il, const key_compare &comp = key_compare()) :_tree(il, comp) {};
+
+	BTreeMap& operator=(const BTreeMap &x) {
+		_tree.assign(x._tree);
+		return *this;
+	}
+
+	BTreeMap& operator=(std::initializer_list<value_type> il) {
+		_tree.assign(il);
+		return *this;
+	}
+
+	iterator begin()const {
+		return _tree.begin();
+	}
+
+	iterator end()const {
+		return _tree.end();
+	}
+
+	reverse_iterator rbegin()const {
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend()const {
+		return reverse_iterator(begin());
+	}
+
+	const_iterator cbegin()const {
+		return _tree.begin();
+	}
+
+	const_iterator cend()const {
+		return _tree.end();
+	}
+
+	const_reverse_iterator crbegin()const {
+		return const_reverse_iterator(end());
+	}
+
+	const_reverse_iterator crend()const {
+		return const_reverse_iterator(begin());
+	}
+
+	bool empty()const {
+		return _tree.empty();
+	}
+
+	size_type size()const {
+		return _tree.size();
+	}
+
+	size_type max_size()const {
+		return -1;
+	}
+
+	//values held by one node
+	static size_type node_slots() {
+		return tree_type::slots;
+	}
+
+	mapped_type& operator[](const key_type &k) {
+		return (*((_tree.insert_unique(std::make_pair(k, mapped_type()))).first)).second;
+	}
+
+	mapped_type& at(const key_type &k) {
+		auto it = _tree.find(k);
+		if (it == _tree.end())
+			throw std::exception("");
+		return it->second;
+	}
+
+	std::pair<iterator, bool> insert(const value_type &val) {
+		return _tree.insert_unique(val);
+	}
+
+	iterator insert(const_iterator position, const value_type &val) {
+		return _tree.insert_unique(iterator(position), val);
+	}
+
+	template<typename InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		_tree.insert_unique(first, last);
+	}
+
+	void insert(std::initializer_list<value_type> il) {
+		_tree.insert_unique(il.begin(), il.end());
+	}
+
+	iterator erase(const_iterator position) {
+		return _tree.erase(iterator(position));
+	}
+
+	size_type erase(const key_type &k) {
+		return _tree.erase(k);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		return _tree.erase(iterator(first), iterator(last));
+	}
+
+	void swap(BTreeMap &x) {
+		_tree.swap(x._tree);
+	}
+
+	void clear() {
+		_tree.clear();
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		value_type val(args...);
+		return insert(val);
+	}
+
+	template<typename... Args>
+	iterator emplace_hint(const_iterator position, Args&&... args) {
+		value_type val(args...);
+		return insert(position, val);
+	}
+
+	iterator find(const key_type &k)const {
+		return _tree.find(k);
+	}
+
+	size_type count(const key_type &k)const {
+		return _tree.find(k) != end();
+	}
+
+	iterator lower_bound(const key_type &k)const {
+		return _tree.lower_bound(k);
+	}
+
+	iterator upper_bound(const key_type &k)const {
+		return _tree.upper_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &k)const {
+		return _tree.find(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	size_type count(const K &k)const {
+		return _tree.find(k) != end();
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &k)const {
+		return _tree.lower_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &k)const {
+		return _tree.upper_bound(k);
+	}
+};
+
+#endif // !BTREEMAP_H
\ No newline at end of file
@@ -0,0 +1,164 @@
+#ifndef BTREESET_H
+#define BTREESET_H
+#include"BTree.h"
+#include"Set.h"
+
+//Set interface over a B-tree with wide nodes, see BTree. Inserts and erases invalidate iterators.
+template<typename T, typename Compare = std::less<T>, size_t NodeBytes = 256>
+class BTreeSet {
+public:
+	typedef T                                                 key_type;
+	typedef T                                                 value_type;
+	typedef Compare                                           key_compare;
+	typedef Compare                                           value_compare;
+	typedef T&                                                reference;
+	typedef const T&                                          const_reference;
+	typedef T*                                                pointer;
+	typedef const T*                                          const_pointer;
+	typedef BTree<T, T, identity<T>, Compare, NodeBytes>      tree_type;
+	typedef const_btree_iterator<T, T&, T*, tree_type::slots> iterator;
+	typedef std::reverse_iterator<iterator>                   reverse_iterator;
+	typedef ptrdiff_t                                         difference_type;
+	typedef size_t                                            size_type;
+private:
+	tree_type _tree;
+public:
+	explicit BTreeSet(const key_compare &comp = key_compare()) :_tree(comp) {};
+
+	template<typename InputIterator>
+	BTreeSet(InputIterator first, InputIterator last, const key_compare &comp = key_compare()) :_tree(first, last, comp) {};
+
+	BTreeSet(const BTreeSet &x) :_tree(x._tree) {};
+
+	BTreeSet(std::initializer_list<value_type> il, const key_compare &comp = key_compare()) :_tree(il, comp) {};
+
+	BTreeSet& operator=(const BTreeSet &x) {
+		_tree.assign(x._tree);
+		return *this;
+	}
+
+	BTreeSet& operator=(std::initializer_list<value_type> il) {
+		_tree.assign(il);
+		return *this;
+	}
+
+	iterator begin()const {
+		return _tree.begin();
+	}
+
+	iterator end()const {
+		return _tree.end();
+	}
+
+	reverse_iterator rbegin()const {
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend()const {
+		return reverse_iterator(begin());
+	}
+
+	bool empty()const {
+		return _tree.empty();
+	}
+
+	size_type size()const {
+		return _tree.size();
+	}
+
+	size_type max_size()const {
+		return -1;
+	}
+
+	//values held by one node
+	static size_type node_slots() {
+		return tree_type::slots;
+	}
+
+	std::pair<iterator, bool> insert(const value_type &val) {
+		return _tree.insert_unique(val);
+	}
+
+	iterator insert(iterator position, const value_type &val) {
+		return _tree.insert_unique(position, val);
+	}
+
+	template<typename InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		_tree.insert_unique(first, last);
+	}
+
+	void insert(std::initializer_list<value_type> il) {
+		_tree.insert_unique(il.begin(), il.end());
+	}
+
+	iterator erase(iterator position) {
+		return _tree.erase(position);
+	}
+
+	size_type erase(const key_type &k) {
+		return _tree.erase(k);
+	}
+
+	iterator erase(iterator first, iterator last) {
+		return _tree.erase(first, last);
+	}
+
+	void swap(BTreeSet &x) {
+		_tree.swap(x._tree);
+	}
+
+	void clear() {
+		_tree.clear();
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		value_type val(args...);
+		return _tree.insert_unique(val);
+	}
+
+	template<typename... Args>
+	iterator emplace_hint(iterator position, Args&&... args) {
+		value_type val(args...);
+		return _tree.insert_unique(position, val);
+	}
+
+	iterator find(const value_type &x)const {
+		return _tree.find(x);
+	}
+
+	size_type count(const value_type &x)const {
+		return _tree.find(x) != end();
+	}
+
+	iterator lower_bound(const value_type &x)const {
+		return _tree.lower_bound(x);
+	}
+
+	iterator upper_bound(const value_type &x)const {
+		return _tree.upper_bound(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &x)const {
+		return _tree.find(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	size_type count(const K &x)const {
+		return _tree.find(x) != end();
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &x)const {
+		return _tree.lower_bound(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &x)const {
+		return _tree.upper_bound(x);
+	}
+};
+
+#endif // !BTREESET_H
\ No newline at end of file
@@ -0,0 +1,210 @@
+#ifndef CONCURRENTMAP_H
+#define CONCURRENTMAP_H
+#include<shared_mutex>
+#include<mutex>
+#include<functional>
+#include<utility>
+#include"Map.h"
+#include"Vector.h"
+
+//one cache line apart, so writers on neighbouring shards do not bounce the same line
+template<typename MapType>
+struct alignas(64) concurrent_shard {
+	mutable std::shared_mutex _mutex;
+	MapType _map;
+};
+
+//Keys are spread over Shards independent Maps by hash, each behind its own reader-writer lock, so point operations
+//on different shards never contend. Ordered reads copy what they need from every shard under that shard's shared lock
+//and merge the sorted runs; each shard is seen consistently, the shards together are not one atomic snapshot.
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Hash = std::hash<Key>, size_t Shards = 16>
+class ConcurrentMap {
+public:
+	typedef Key                                key_type;
+	typedef T                                  mapped_type;
+	typedef std::pair<const Key, T>            value_type;
+	typedef Compare                            key_compare;
+	typedef Hash                               hasher;
+	typedef size_t                             size_type;
+	typedef Map<Key, T, Compare>               shard_type;
+	//copies handed out by the ordered reads
+	typedef std::pair<Key, T>                  entry_type;
+	typedef Vector<entry_type>                 entry_vector;
+private:
+	concurrent_shard<shard_type> _shards[Shards];
+	Compare _keyCompare;
+	Hash _hash;
+public:
+	explicit ConcurrentMap(const key_compare &comp = key_compare(), const hasher &hash = hasher()) :_keyCompare(comp), _hash(hash) {
+		for (size_type i = 0; i < Shards; ++i)
+			_shards[i]._map = shard_type(comp);
+	};
+
+	ConcurrentMap(const ConcurrentMap&) = delete;
+
+	ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+	static size_type shard_count() {
+		return Shards;
+	}
+
+	//sum of the shard sizes, each read under its own lock
+	size_type size()const {
+		size_type n = 0;
+		for (size_type i = 0; i < Shards; ++i) {
+			std::shared_lock<std::shared_mutex> lock(_shards[i]._mutex);
+			n += _shards[i]._map.size();
+		}
+		return n;
+	}
+
+	bool empty()const {
+		return size() == 0;
+	}
+
+	bool insert(const value_type &val) {
+		concurrent_shard<shard_type> &shard = _shard(val.first);
+		std::unique_lock<std::shared_mutex> lock(shard._mutex);
+		return shard._map.insert(val).second;
+	}
+
+	//true if the key was new
+	bool insert_or_assign(const key_type &k, const mapped_type &obj) {
+		concurrent_shard<shard_type> &shard = _shard(k);
+		std::unique_lock<std::shared_mutex> lock(shard._mutex);
+		auto res = shard._map.insert(value_type(k, obj));
+		if (!res.second)
+			res.first->second = obj;
+		return res.second;
+	}
+
+	size_type erase(const key_type &k) {
+		concurrent_shard<shard_type> &shard = _shard(k);
+		std::unique_lock<std::shared_mutex> lock(shard._mutex);
+		return shard._map.erase(k);
+	}
+
+	//copies the value into out, false if the key is absent
+	bool find(const key_type &k, mapped_type &out)const {
+		const concurrent_shard<shard_type> &shard = _shard(k);
+		std::shared_lock<std::shared_mutex> lock(shard._mutex);
+		auto it = shard._map.find(k);
+		if (it == shard._map.end())
+			return false;
+		out = it->second;
+		return true;
+	}
+
+	bool contains(const key_type &k)const {
+		const concurrent_shard<shard_type> &shard = _shard(k);
+		std::shared_lock<std::shared_mutex> lock(shard._mutex);
+		return shard._map.find(k) != shard._map.end();
+	}
+
+	//calls f(mapped_type&) under the shard's exclusive lock, false if the key is absent
+	template<typename F>
+	bool update(const key_type &k, F f) {
+		concurrent_shard<shard_type> &shard = _shard(k);
+		std::unique_lock<std::shared_mutex> lock(shard._mutex);
+		auto it = shard._map.find(k);
+		if (it == shard._map.end())
+			return false;
+		f(it->second);
+		return true;
+	}
+
+	void clear() {
+		for (size_type i = 0; i < Shards; ++i) {
+			std::unique_lock<std::shared_mutex> lock(_shards[i]._mutex);
+			_shards[i]._map.clear();
+		}
+	}
+
+	//smallest entry whose key is not less than k, false if there is none
+	bool lower_bound(const key_type &k, entry_type &out)const {
+		bool found = false;
+		for (size_type i = 0; i < Shards; ++i) {
+			std::shared_lock<std::shared_mutex> lock(_shards[i]._mutex);
+			auto it = _shards[i]._map.lower_bound(k);
+			if (it != _shards[i]._map.end() && (!found || _keyCompare(it->first, out.first))) {
+				out = entry_type(it->first, it->second);
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	//entries with keys in [lo, hi) in key order, at most limit of them
+	entry_vector range(const key_type &lo, const key_type &hi, size_type limit = size_type(-1))const {
+		entry_vector runs[Shards];
+		for (size_type i = 0; i < Shards; ++i) {
+			std::shared_lock<std::shared_mutex> lock(_shards[i]._mutex);
+			const shard_type &map = _shards[i]._map;
+			size_type n = 0;
+			for (auto it = map.lower_bound(lo); it != map.end() && n < limit && _keyCompare(it->first, hi); ++it, ++n)
+				runs[i].push_back(entry_type(it->first, it->second));
+		}
+		entry_vector res;
+		_merge(runs, limit, [&res](const entry_type &x) { res.push_back(x); });
+		return res;
+	}
+
+	//every entry in key order
+	entry_vector snapshot()const {
+		entry_vector runs[Shards];
+		size_type n = _copy_runs(runs);
+		entry_vector res;
+		res.reserve(n);
+		_merge(runs, n, [&res](const entry_type &x) { res.push_back(x); });
+		return res;
+	}
+
+	//calls f(const entry_type&) on every entry in key order, without holding any lock during the calls
+	template<typename F>
+	void for_each(F f)const {
+		entry_vector runs[Shards];
+		size_type n = _copy_runs(runs);
+		_merge(runs, n, f);
+	}
+private:
+	concurrent_shard<shard_type>& _shard(const key_type &k) {
+		return _shards[_hash(k) % Shards];
+	}
+
+	const concurrent_shard<shard_type>& _shard(const key_type &k)const {
+		return _shards[_hash(k) % Shards];
+	}
+
+	size_type _copy_runs(entry_vector *runs)const {
+		size_type n = 0;
+		for (size_type i = 0; i < Shards; ++i) {
+			std::shared_lock<std::shared_mutex> lock(_shards[i]._mutex);
+			const shard_type &map = _shards[i]._map;
+			runs[i].reserve(map.size());
+			for (auto it = map.begin(); it != map.end(); ++it)
+				runs[i].push_back(entry_type(it->first, it->second));
+			n += map.size();
+		}
+		return n;
+	}
+
+	//Shards is small, so the next entry is picked by a linear scan over the run heads
+	template<typename F>
+	void _merge(entry_vector *runs, size_type limit, F f)const {
+		size_type heads[Shards] = {};
+		for (size_type n = 0; n < limit; ++n) {
+			size_type best = Shards;
+			for (size_type i = 0; i < Shards; ++i) {
+				if (heads[i] == runs[i].size())
+					continue;
+				if (best == Shards || _keyCompare(runs[i].data()[heads[i]].first, runs[best].data()[heads[best]].first))
+					best = i;
+			}
+			if (best == Shards)
+				return;
+			f(runs[best].data()[heads[best]++]);
+		}
+	}
+};
+
+#endif // !CONCURRENTMAP_H
\ No newline at end of file
@@ -486,21 +486,24 @@ public:
 			_reallocate_map(1, false);
 		}
 		if (*_end._node == nullptr) {
+			bool emptyNode = _start._node == _end._node;
 			*_end._node = _alloc.allocate(_buffer_size());
 			_end._set_node(_end._node);
 			_end._cur = _end._first;
+			if (emptyNode)
+				_start = _end;
 		}
 		_alloc.construct(_end._cur, val);
+		if (_end._cur == _end._last - 1 && _end._node == _map + _mapSize - 1)
+			_reallocate_map(1, false);
 		++_end;
 	}
 
 	void push_front(const value_type &val) {
-		--_start;
-		if (_start._node < _map) {
-			++_start;
+		//stepping back from the first slot of _map[0] would read the map entry before _map
+		if (_start._cur == _start._first && _start._node == _map)
 			_reallocate_map(1, true);
-			--_start;
-		}
+		--_start;
 		if (*_start._node == nullptr) {
 			*_start._node = _alloc.allocate(_buffer_size());
 			_start._set_node(_start._node);
@@ -516,7 +519,15 @@ public:
 
 	void pop_front() {
 		_alloc.destroy(_start._cur);
-		++_start;
+		if (_start._cur == _start._last - 1 && _start._node != _end._node) {
+			//release the drained buffer, a deque used as a FIFO would keep all of them otherwise
+			map_pointer drainedNode = _start._node;
+			++_start;
+			_alloc.deallocate(*drainedNode, _buffer_size());
+			*drainedNode = nullptr;
+		}
+		else
+			++_start;
 	}
 
 	iterator insert(const_iterator position, const value_type &val) {
@@ -631,6 +642,12 @@ private:
 	}
 
 	void _reallocate_map(size_type newNodesNum, bool addToFront) {
+		map_pointer lastNode = _end._node < _map + _mapSize ? _end._node : _map + _mapSize - 1;
+		size_type usedNodesNum = lastNode - _start._node + 1;
+		if (_mapSize > 2 * (usedNodesNum + newNodesNum)) {
+			_recenter_map(lastNode, usedNodesNum, newNodesNum, addToFront);
+			return;
+		}
 		size_type newMapSize = _mapSize + (_mapSize > newNodesNum ? _mapSize : newNodesNum) + 2;
 		map_pointer newMap = new pointer[newMapSize];
 		memset(newMap, 0, sizeof(pointer) * newMapSize);
@@ -648,6 +665,25 @@ private:
 		_mapSize = newMapSize;
 	}
 	
+	void _recenter_map(map_pointer lastNode, size_type usedNodesNum, size_type newNodesNum, bool addToFront) {
+		//the map is mostly free space, slide the used nodes back to the middle instead of growing it
+		size_type oriSize = size();
+		for (map_pointer node = _map; node != _map + _mapSize; ++node)
+			if (*node && (node < _start._node || node > lastNode)) {
+				_alloc.deallocate(*node, _buffer_size());
+				*node = nullptr;
+			}
+		map_pointer startNode = _map + ((_mapSize - (usedNodesNum + newNodesNum)) >> 1);
+		if (addToFront)
+			startNode += newNodesNum;
+		memmove(startNode, _start._node, sizeof(pointer) * usedNodesNum);
+		for (map_pointer node = _map; node != _map + _mapSize; ++node)
+			if (node < startNode || node >= startNode + usedNodesNum)
+				*node = nullptr;
+		_start._set_node(startNode);
+		_end = _start + oriSize;
+	}
+
 	size_type _buffer_size() {
 		return sizeof(value_type) > 512 ? 1 : 512 / sizeof(value_type);
 	}
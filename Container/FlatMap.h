@@ -0,0 +1,492 @@
+#ifndef FLATMAP_H
+#define FLATMAP_H
+#include<functional>
+#include<algorithm>
+#include<iterator>
+#include<initializer_list>
+#include<utility>
+#include"Vector.h"
+
+//Walks the key and value columns side by side. Dereferencing gives a pair of references, not a stored pair,
+//so operator-> hands out a small proxy that keeps that pair alive for the duration of the expression.
+template<typename Key, typename T>
+class flat_map_iterator {
+public:
+	typedef std::pair<const Key, T>                  value_type;
+	typedef std::pair<const Key&, T&>                reference;
+	typedef ptrdiff_t                                difference_type;
+	typedef std::random_access_iterator_tag          iterator_category;
+
+	class pointer {
+		reference _ref;
+	public:
+		pointer(const reference &ref) :_ref(ref) {};
+
+		const reference* operator->()const {
+			return &_ref;
+		}
+	};
+private:
+	const Key *_key;
+	T *_value;
+public:
+	flat_map_iterator() :_key(nullptr), _value(nullptr) {};
+
+	flat_map_iterator(const Key *key, T *value) :_key(key), _value(value) {};
+
+	//iterator to const_iterator
+	template<typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	flat_map_iterator(const flat_map_iterator<Key, U> &x) :_key(x._Key()), _value(x._Value()) {};
+
+	bool operator==(const flat_map_iterator &x)const {
+		return _key == x._key;
+	}
+
+	bool operator!=(const flat_map_iterator &x)const {
+		return _key != x._key;
+	}
+
+	bool operator<(const flat_map_iterator &x)const {
+		return _key < x._key;
+	}
+
+	bool operator>(const flat_map_iterator &x)const {
+		return _key > x._key;
+	}
+
+	bool operator<=(const flat_map_iterator &x)const {
+		return _key <= x._key;
+	}
+
+	bool operator>=(const flat_map_iterator &x)const {
+		return _key >= x._key;
+	}
+
+	reference operator*()const {
+		return reference(*_key, *_value);
+	}
+
+	pointer operator->()const {
+		return pointer(**this);
+	}
+
+	reference operator[](difference_type n)const {
+		return reference(_key[n], _value[n]);
+	}
+
+	flat_map_iterator& operator++() {
+		++_key;
+		++_value;
+		return *this;
+	}
+
+	flat_map_iterator operator++(int) {
+		flat_map_iterator ret(*this);
+		++*this;
+		return ret;
+	}
+
+	flat_map_iterator& operator--() {
+		--_key;
+		--_value;
+		return *this;
+	}
+
+	flat_map_iterator operator--(int) {
+		flat_map_iterator ret(*this);
+		--*this;
+		return ret;
+	}
+
+	flat_map_iterator& operator+=(difference_type n) {
+		_key += n;
+		_value += n;
+		return *this;
+	}
+
+	flat_map_iterator& operator-=(difference_type n) {
+		_key -= n;
+		_value -= n;
+		return *this;
+	}
+
+	flat_map_iterator operator+(difference_type n)const {
+		return flat_map_iterator(_key + n, _value + n);
+	}
+
+	flat_map_iterator operator-(difference_type n)const {
+		return flat_map_iterator(_key - n, _value - n);
+	}
+
+	difference_type operator-(const flat_map_iterator &x)const {
+		return _key - x._key;
+	}
+
+	const Key* _Key()const {
+		return _key;
+	}
+
+	T* _Value()const {
+		return _value;
+	}
+};
+
+//Map interface over two sorted Vector columns, keys and values. Lookups are a binary search over the key column only,
+//a single insert or erase shifts the tail, and a range insert sorts the new entries and merges them in one pass.
+//Inserts and erases invalidate iterators.
+template<typename Key, typename T, typename Compare = std::less<Key>>
+class FlatMap {
+public:
+	typedef Key                                     key_type;
+	typedef T                                       mapped_type;
+	typedef std::pair<const Key, T>                 value_type;
+	typedef Compare                                 key_compare;
+	typedef flat_map_iterator<Key, T>               iterator;
+	typedef flat_map_iterator<Key, const T>         const_iterator;
+	typedef typename iterator::reference            reference;
+	typedef typename const_iterator::reference      const_reference;
+	typedef std::reverse_iterator<iterator>         reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>   const_reverse_iterator;
+	typedef ptrdiff_t                               difference_type;
+	typedef size_t                                  size_type;
+private:
+	Vector<Key> _keys;
+	Vector<T> _values;
+	Compare _keyCompare;
+public:
+	explicit FlatMap(const key_compare &comp = key_compare()) :_keyCompare(comp) {};
+
+	template<typename InputIterator>
+	FlatMap(InputIterator first, InputIterator last, const key_compare &comp = key_compare()) :_keyCompare(comp) {
+		insert(first, last);
+	};
+
+	FlatMap(const FlatMap &x) :_keys(x._keys), _values(x._values), _keyCompare(x._keyCompare) {};
+
+	FlatMap(std::initializer_list<value_type> il, const key_compare &comp = key_compare()) :_keyCompare(comp) {
+		insert(il.begin(), il.end());
+	};
+
+	FlatMap& operator=(const FlatMap &x) {
+		_keys = x._keys;
+		_values = x._values;
+		_keyCompare = x._keyCompare;
+		return *this;
+	}
+
+	FlatMap& operator=(std::initializer_list<value_type> il) {
+		clear();
+		insert(il.begin(), il.end());
+		return *this;
+	}
+
+	iterator begin() {
+		return iterator(_keys.data(), _values.data());
+	}
+
+	const_iterator begin()const {
+		return const_iterator(_keys.data(), _values.data());
+	}
+
+	iterator end() {
+		return iterator(_keys.data() + _keys.size(), _values.data() + _values.size());
+	}
+
+	const_iterator end()const {
+		return const_iterator(_keys.data() + _keys.size(), _values.data() + _values.size());
+	}
+
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin()const {
+		return const_reverse_iterator(end());
+	}
+
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend()const {
+		return const_reverse_iterator(begin());
+	}
+
+	const_iterator cbegin()const {
+		return begin();
+	}
+
+	const_iterator cend()const {
+		return end();
+	}
+
+	bool empty()const {
+		return _keys.empty();
+	}
+
+	size_type size()const {
+		return _keys.size();
+	}
+
+	size_type max_size()const {
+		return -1;
+	}
+
+	size_type capacity()const {
+		return _keys.capacity();
+	}
+
+	void reserve(size_type n) {
+		_keys.reserve(n);
+		_values.reserve(n);
+	}
+
+	void shrink_to_fit() {
+		_keys.shrink_to_fit();
+		_values.shrink_to_fit();
+	}
+
+	mapped_type& operator[](const key_type &k) {
+		size_type i = _lower_index(k);
+		if (i == size() || _keyCompare(k, _keys.data()[i]))
+			_insert_at(i, k, mapped_type());
+		return _values.data()[i];
+	}
+
+	mapped_type& at(const key_type &k) {
+		size_type i = _find_index(k);
+		if (i == size())
+			throw std::exception("");
+		return _values.data()[i];
+	}
+
+	const mapped_type& at(const key_type &k)const {
+		size_type i = _find_index(k);
+		if (i == size())
+			throw std::exception("");
+		return _values.data()[i];
+	}
+
+	std::pair<iterator, bool> insert(const value_type &val) {
+		size_type i = _lower_index(val.first);
+		if (i < size() && !_keyCompare(val.first, _keys.data()[i]))
+			return std::pair<iterator, bool>(begin() + i, false);
+		_insert_at(i, val.first, val.second);
+		return std::pair<iterator, bool>(begin() + i, true);
+	}
+
+	//no search when val belongs right before position
+	iterator insert(const_iterator position, const value_type &val) {
+		size_type i = position - cbegin();
+		if ((i == size() || _keyCompare(val.first, _keys.data()[i])) && (i == 0 || _keyCompare(_keys.data()[i - 1], val.first))) {
+			_insert_at(i, val.first, val.second);
+			return begin() + i;
+		}
+		return insert(val).first;
+	}
+
+	//Sorts the new entries (stably, so the first of equal keys wins, as with repeated insert) and merges them
+	//with the current columns in one pass; keys already present keep their values.
+	template<typename InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		Vector<std::pair<Key, T>> items;
+		for (; first != last; ++first)
+			items.push_back(std::pair<Key, T>((*first).first, (*first).second));
+		if (items.empty())
+			return;
+		std::stable_sort(items.begin(), items.end(), [this](const std::pair<Key, T> &a, const std::pair<Key, T> &b) {
+			return _keyCompare(a.first, b.first);
+		});
+		_merge_sorted(items);
+	}
+
+	void insert(std::initializer_list<value_type> il) {
+		insert(il.begin(), il.end());
+	}
+
+	iterator erase(const_iterator position) {
+		return erase(position, position + 1);
+	}
+
+	size_type erase(const key_type &k) {
+		size_type i = _find_index(k);
+		if (i == size())
+			return 0;
+		erase(cbegin() + i);
+		return 1;
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		size_type i = first - cbegin();
+		size_type n = last - first;
+		if (n == 0)
+			return begin() + i;
+		std::move(_keys.begin() + i + n, _keys.end(), _keys.begin() + i);
+		std::move(_values.begin() + i + n, _values.end(), _values.begin() + i);
+		while (n--) {
+			_keys.pop_back();
+			_values.pop_back();
+		}
+		return begin() + i;
+	}
+
+	//Vector::swap copies element by element and needs equal sizes, moving the buffers is O(1) and cannot throw
+	void swap(FlatMap &x) {
+		_swap_storage(_keys, x._keys);
+		_swap_storage(_values, x._values);
+		std::swap(_keyCompare, x._keyCompare);
+	}
+
+	void clear() {
+		_keys.clear();
+		_values.clear();
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		value_type val(args...);
+		return insert(val);
+	}
+
+	template<typename... Args>
+	iterator emplace_hint(const_iterator position, Args&&... args) {
+		value_type val(args...);
+		return insert(position, val);
+	}
+
+	iterator find(const key_type &k) {
+		return begin() + _find_index(k);
+	}
+
+	const_iterator find(const key_type &k)const {
+		return begin() + _find_index(k);
+	}
+
+	size_type count(const key_type &k)const {
+		return _find_index(k) != size();
+	}
+
+	iterator lower_bound(const key_type &k) {
+		return begin() + _lower_index(k);
+	}
+
+	const_iterator lower_bound(const key_type &k)const {
+		return begin() + _lower_index(k);
+	}
+
+	iterator upper_bound(const key_type &k) {
+		return begin() + _upper_index(k);
+	}
+
+	const_iterator upper_bound(const key_type &k)const {
+		return begin() + _upper_index(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	const_iterator find(const K &k)const {
+		return begin() + _find_index(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	size_type count(const K &k)const {
+		return _find_index(k) != size();
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	const_iterator lower_bound(const K &k)const {
+		return begin() + _lower_index(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	const_iterator upper_bound(const K &k)const {
+		return begin() + _upper_index(k);
+	}
+private:
+	template<typename U>
+	static void _swap_storage(Vector<U> &a, Vector<U> &b) {
+		Vector<U> tmp(std::move(a));
+		a = std::move(b);
+		b = std::move(tmp);
+	}
+
+	//branchless halving over the key column, the comparison only picks the next base
+	template<typename K>
+	size_type _lower_index(const K &k)const {
+		size_type n = _keys.size();
+		if (n == 0)
+			return 0;
+		const Key *keys = _keys.data();
+		size_type lo = 0;
+		while (n > 1) {
+			size_type half = n / 2;
+			lo = _keyCompare(keys[lo + half], k) ? lo + half : lo;
+			n -= half;
+		}
+		return lo + _keyCompare(keys[lo], k);
+	}
+
+	template<typename K>
+	size_type _upper_index(const K &k)const {
+		size_type n = _keys.size();
+		if (n == 0)
+			return 0;
+		const Key *keys = _keys.data();
+		size_type lo = 0;
+		while (n > 1) {
+			size_type half = n / 2;
+			lo = _keyCompare(k, keys[lo + half]) ? lo : lo + half;
+			n -= half;
+		}
+		return lo + !_keyCompare(k, keys[lo]);
+	}
+
+	//size() when absent
+	template<typename K>
+	size_type _find_index(const K &k)const {
+		size_type i = _lower_index(k);
+		if (i == size() || _keyCompare(k, _keys.data()[i]))
+			return size();
+		return i;
+	}
+
+	//appends, then rotates the new entry into place, which only needs moves
+	void _insert_at(size_type i, const key_type &k, const mapped_type &obj) {
+		_keys.push_back(k);
+		_values.push_back(obj);
+		std::rotate(_keys.begin() + i, _keys.end() - 1, _keys.end());
+		std::rotate(_values.begin() + i, _values.end() - 1, _values.end());
+	}
+
+	//on equal keys the current entry is taken first, and any later equal one is dropped against the output's back
+	void _merge_sorted(const Vector<std::pair<Key, T>> &items) {
+		Vector<Key> keys;
+		Vector<T> values;
+		keys.reserve(size() + items.size());
+		values.reserve(size() + items.size());
+		const Key *oldKeys = _keys.data();
+		const T *oldValues = _values.data();
+		const std::pair<Key, T> *newItems = items.data();
+		size_type n = size();
+		size_type m = items.size();
+		size_type i = 0;
+		size_type j = 0;
+		while (i < n || j < m) {
+			if (j == m || (i < n && !_keyCompare(newItems[j].first, oldKeys[i]))) {
+				keys.push_back(oldKeys[i]);
+				values.push_back(oldValues[i]);
+				++i;
+			}
+			else {
+				if (keys.empty() || _keyCompare(keys.back(), newItems[j].first)) {
+					keys.push_back(newItems[j].first);
+					values.push_back(newItems[j].second);
+				}
+				++j;
+			}
+		}
+		_keys = std::move(keys);
+		_values = std::move(values);
+	}
+};
+
+#endif // !FLATMAP_H
\ No newline at end of file
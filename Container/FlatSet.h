@@ -0,0 +1,282 @@
+#ifndef FLATSET_H
+#define FLATSET_H
+#include<functional>
+#include<algorithm>
+#include<iterator>
+#include<initializer_list>
+#include<utility>
+#include"Vector.h"
+
+//Set interface over one sorted Vector. Lookups are a binary search, a single insert or erase shifts the tail,
+//and a range insert sorts the new elements and merges them in one pass. Inserts and erases invalidate iterators.
+template<typename T, typename Compare = std::less<T>>
+class FlatSet {
+public:
+	typedef T                                     key_type;
+	typedef T                                     value_type;
+	typedef Compare                               key_compare;
+	typedef Compare                               value_compare;
+	typedef T&                                    reference;
+	typedef const T&                              const_reference;
+	typedef T*                                    pointer;
+	typedef const T*                              const_pointer;
+	typedef const T*                              iterator;
+	typedef std::reverse_iterator<iterator>       reverse_iterator;
+	typedef ptrdiff_t                             difference_type;
+	typedef size_t                                size_type;
+private:
+	Vector<T> _data;
+	Compare _keyCompare;
+public:
+	explicit FlatSet(const key_compare &comp = key_compare()) :_keyCompare(comp) {};
+
+	template<typename InputIterator>
+	FlatSet(InputIterator first, InputIterator last, const key_compare &comp = key_compare()) :_keyCompare(comp) {
+		insert(first, last);
+	};
+
+	FlatSet(const FlatSet &x) :_data(x._data), _keyCompare(x._keyCompare) {};
+
+	FlatSet(std::initializer_list<value_type> il, const key_compare &comp = key_compare()) :_keyCompare(comp) {
+		insert(il.begin(), il.end());
+	};
+
+	FlatSet& operator=(const FlatSet &x) {
+		_data = x._data;
+		_keyCompare = x._keyCompare;
+		return *this;
+	}
+
+	FlatSet& operator=(std::initializer_list<value_type> il) {
+		clear();
+		insert(il.begin(), il.end());
+		return *this;
+	}
+
+	iterator begin()const {
+		return _data.data();
+	}
+
+	iterator end()const {
+		return _data.data() + _data.size();
+	}
+
+	reverse_iterator rbegin()const {
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend()const {
+		return reverse_iterator(begin());
+	}
+
+	bool empty()const {
+		return _data.empty();
+	}
+
+	size_type size()const {
+		return _data.size();
+	}
+
+	size_type max_size()const {
+		return -1;
+	}
+
+	size_type capacity()const {
+		return _data.capacity();
+	}
+
+	void reserve(size_type n) {
+		_data.reserve(n);
+	}
+
+	void shrink_to_fit() {
+		_data.shrink_to_fit();
+	}
+
+	std::pair<iterator, bool> insert(const value_type &val) {
+		size_type i = _lower_index(val);
+		if (i < size() && !_keyCompare(val, _data.data()[i]))
+			return std::pair<iterator, bool>(begin() + i, false);
+		_insert_at(i, val);
+		return std::pair<iterator, bool>(begin() + i, true);
+	}
+
+	//no search when val belongs right before position
+	iterator insert(iterator position, const value_type &val) {
+		size_type i = position - begin();
+		if ((i == size() || _keyCompare(val, _data.data()[i])) && (i == 0 || _keyCompare(_data.data()[i - 1], val))) {
+			_insert_at(i, val);
+			return begin() + i;
+		}
+		return insert(val).first;
+	}
+
+	//sorts the new elements and merges them with the current ones in one pass
+	template<typename InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		Vector<T> items;
+		for (; first != last; ++first)
+			items.push_back(*first);
+		if (items.empty())
+			return;
+		std::stable_sort(items.begin(), items.end(), _keyCompare);
+		_merge_sorted(items);
+	}
+
+	void insert(std::initializer_list<value_type> il) {
+		insert(il.begin(), il.end());
+	}
+
+	iterator erase(iterator position) {
+		return erase(position, position + 1);
+	}
+
+	size_type erase(const key_type &k) {
+		size_type i = _find_index(k);
+		if (i == size())
+			return 0;
+		erase(begin() + i);
+		return 1;
+	}
+
+	iterator erase(iterator first, iterator last) {
+		size_type i = first - begin();
+		size_type n = last - first;
+		if (n == 0)
+			return begin() + i;
+		std::move(_data.begin() + i + n, _data.end(), _data.begin() + i);
+		while (n--)
+			_data.pop_back();
+		return begin() + i;
+	}
+
+	//Vector::swap copies element by element and needs equal sizes, moving the buffers is O(1) and cannot throw
+	void swap(FlatSet &x) {
+		Vector<T> tmp(std::move(_data));
+		_data = std::move(x._data);
+		x._data = std::move(tmp);
+		std::swap(_keyCompare, x._keyCompare);
+	}
+
+	void clear() {
+		_data.clear();
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		value_type val(args...);
+		return insert(val);
+	}
+
+	template<typename... Args>
+	iterator emplace_hint(iterator position, Args&&... args) {
+		value_type val(args...);
+		return insert(position, val);
+	}
+
+	iterator find(const value_type &x)const {
+		return begin() + _find_index(x);
+	}
+
+	size_type count(const value_type &x)const {
+		return _find_index(x) != size();
+	}
+
+	iterator lower_bound(const value_type &x)const {
+		return begin() + _lower_index(x);
+	}
+
+	iterator upper_bound(const value_type &x)const {
+		return begin() + _upper_index(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &x)const {
+		return begin() + _find_index(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	size_type count(const K &x)const {
+		return _find_index(x) != size();
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &x)const {
+		return begin() + _lower_index(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &x)const {
+		return begin() + _upper_index(x);
+	}
+private:
+	//branchless halving, the comparison only picks the next base
+	template<typename K>
+	size_type _lower_index(const K &k)const {
+		size_type n = _data.size();
+		if (n == 0)
+			return 0;
+		const T *data = _data.data();
+		size_type lo = 0;
+		while (n > 1) {
+			size_type half = n / 2;
+			lo = _keyCompare(data[lo + half], k) ? lo + half : lo;
+			n -= half;
+		}
+		return lo + _keyCompare(data[lo], k);
+	}
+
+	template<typename K>
+	size_type _upper_index(const K &k)const {
+		size_type n = _data.size();
+		if (n == 0)
+			return 0;
+		const T *data = _data.data();
+		size_type lo = 0;
+		while (n > 1) {
+			size_type half = n / 2;
+			lo = _keyCompare(k, data[lo + half]) ? lo : lo + half;
+			n -= half;
+		}
+		return lo + !_keyCompare(k, data[lo]);
+	}
+
+	//size() when absent
+	template<typename K>
+	size_type _find_index(const K &k)const {
+		size_type i = _lower_index(k);
+		if (i == size() || _keyCompare(k, _data.data()[i]))
+			return size();
+		return i;
+	}
+
+	//appends, then rotates the new element into place, which only needs moves
+	void _insert_at(size_type i, const value_type &val) {
+		_data.push_back(val);
+		std::rotate(_data.begin() + i, _data.end() - 1, _data.end());
+	}
+
+	//on equal elements the current one is taken first, and any later equal one is dropped against the output's back
+	void _merge_sorted(const Vector<T> &items) {
+		Vector<T> data;
+		data.reserve(size() + items.size());
+		const T *oldData = _data.data();
+		const T *newData = items.data();
+		size_type n = size();
+		size_type m = items.size();
+		size_type i = 0;
+		size_type j = 0;
+		while (i < n || j < m) {
+			if (j == m || (i < n && !_keyCompare(newData[j], oldData[i])))
+				data.push_back(oldData[i++]);
+			else {
+				if (data.empty() || _keyCompare(data.back(), newData[j]))
+					data.push_back(newData[j]);
+				++j;
+			}
+		}
+		_data = std::move(data);
+	}
+};
+
+#endif // !FLATSET_H
\ No newline at end of file
@@ -0,0 +1,526 @@
+#ifndef FORWARDLIST_H
+#define FORWARDLIST_H
+#include<memory>
+#include<initializer_list>
+#include<iterator>
+#include<type_traits>
+#include"Pool_allocator.h"
+
+template<typename T>
+struct forward_list_node {
+	T _data;
+	forward_list_node *_next;
+
+	explicit forward_list_node(const T &data = T(), forward_list_node *next = nullptr) :_data(data), _next(next) {};
+};
+
+template<typename T, typename Alloc = std::allocator<forward_list_node<T>>>
+class ForwardList;
+
+template<typename T>
+class forward_list_iterator {
+public:
+	typedef T                               value_type;
+	typedef ptrdiff_t                       difference_type;
+	typedef T&                              reference;
+	typedef T*                              pointer;
+	typedef std::forward_iterator_tag       iterator_category;
+	typedef forward_list_node<T>*           link_type;
+protected:
+	link_type _ptr;
+	template<typename, typename> friend class ForwardList;
+public:
+	forward_list_iterator() :_ptr(nullptr) {};
+
+	forward_list_iterator(const link_type ptr) :_ptr(ptr) {};
+
+	forward_list_iterator(const forward_list_iterator &x) :_ptr(x._ptr) {};
+
+	forward_list_iterator& operator=(const forward_list_iterator &x) {
+		_ptr = x._ptr;
+		return *this;
+	}
+
+	bool operator==(const forward_list_iterator &x)const {
+		return _ptr == x._ptr;
+	}
+
+	bool operator!=(const forward_list_iterator &x)const {
+		return _ptr != x._ptr;
+	}
+
+	reference operator*()const {
+		return _ptr->_data;
+	}
+
+	pointer operator->()const {
+		return &(_ptr->_data);
+	}
+
+	forward_list_iterator& operator++() {
+		_ptr = _ptr->_next;
+		return *this;
+	}
+
+	forward_list_iterator operator++(int) {
+		forward_list_iterator retIt(_ptr);
+		_ptr = _ptr->_next;
+		return retIt;
+	}
+
+	link_type Ptr()const {
+		return _ptr;
+	}
+};
+
+template<typename T>
+class const_forward_list_iterator :public forward_list_iterator<T> {
+	template<typename, typename> friend class ForwardList;
+public:
+	typedef T                               value_type;
+	typedef ptrdiff_t                       difference_type;
+	typedef const T&                        reference;
+	typedef const T*                        pointer;
+	typedef std::forward_iterator_tag       iterator_category;
+	typedef forward_list_node<T>*           link_type;
+public:
+	const_forward_list_iterator() :forward_list_iterator<T>() {};
+
+	const_forward_list_iterator(const link_type ptr) :forward_list_iterator<T>(ptr) {};
+
+	const_forward_list_iterator(const forward_list_iterator<T> &x) :forward_list_iterator<T>(x) {};
+
+	reference operator*()const {
+		return this->_ptr->_data;
+	}
+
+	pointer operator->()const {
+		return &(this->_ptr->_data);
+	}
+
+	const_forward_list_iterator& operator++() {
+		this->_ptr = this->_ptr->_next;
+		return *this;
+	}
+
+	const_forward_list_iterator operator++(int) {
+		const_forward_list_iterator retIt(this->_ptr);
+		this->_ptr = this->_ptr->_next;
+		return retIt;
+	}
+};
+
+//Singly linked with a _blankNode in front of the first element, end() is nullptr.
+//There is no cached size, so a list costs one sentinel node and each element one pointer.
+template<typename T, typename Alloc>
+class ForwardList {
+public:
+	typedef Alloc                                 allocator_type;
+	typedef size_t                                size_type;
+	typedef ptrdiff_t                             difference_type;
+	typedef T                                     value_type;
+	typedef T&                                    reference;
+	typedef const T&                              const_reference;
+	typedef forward_list_node<T>*                 link_type;
+	typedef T*                                    pointer;
+	typedef const T*                              const_pointer;
+	typedef forward_list_iterator<T>              iterator;
+	typedef const_forward_list_iterator<T>        const_iterator;
+private:
+	link_type _blankNode;
+	allocator_type _alloc;
+public:
+	explicit ForwardList(const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
+		_init_blanknode();
+	}
+
+	ForwardList(size_type n, const value_type &val, const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
+		_init_blanknode();
+		_insert_bynvals(before_begin(), n, val);
+	}
+
+	template <class InputIterator>
+	ForwardList(InputIterator first, InputIterator last, const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
+		_init_blanknode();
+		_insert_aux(before_begin(), first, last, typename std::is_integral<InputIterator>::type());
+	}
+
+	ForwardList(const ForwardList &x) :_alloc(x._alloc) {
+		_init_blanknode();
+		_insert_byiterator(before_begin(), x.begin(), x.end());
+	}
+
+	ForwardList(std::initializer_list<value_type> il, const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
+		_init_blanknode();
+		_insert_byiterator(before_begin(), il.begin(), il.end());
+	}
+
+	~ForwardList() {
+		clear();
+		_alloc.deallocate(_blankNode, 1);
+	}
+
+	ForwardList& operator=(const ForwardList &x) {
+		if (this == &x)
+			return *this;
+		clear();
+		_insert_byiterator(before_begin(), x.begin(), x.end());
+		return *this;
+	}
+
+	iterator before_begin() {
+		return _blankNode;
+	}
+
+	const_iterator before_begin()const {
+		return _blankNode;
+	}
+
+	iterator begin() {
+		return _blankNode->_next;
+	}
+
+	const_iterator begin()const {
+		return _blankNode->_next;
+	}
+
+	iterator end() {
+		return nullptr;
+	}
+
+	const_iterator end()const {
+		return nullptr;
+	}
+
+	const_iterator cbefore_begin()const {
+		return _blankNode;
+	}
+
+	const_iterator cbegin()const {
+		return _blankNode->_next;
+	}
+
+	const_iterator cend()const {
+		return nullptr;
+	}
+
+	bool empty()const {
+		return _blankNode->_next == nullptr;
+	}
+
+	reference front() {
+		if (empty())
+			throw std::exception("");
+		return _blankNode->_next->_data;
+	}
+
+	const_reference front()const {
+		if (empty())
+			throw std::exception("");
+		return _blankNode->_next->_data;
+	}
+
+	template<typename InputIterator>
+	void assign(InputIterator first, InputIterator last) {
+		ForwardList tempList(first, last, _alloc);
+		swap(tempList);
+	}
+
+	void assign(size_type n, const value_type &val) {
+		clear();
+		_insert_bynvals(before_begin(), n, val);
+	}
+
+	void assign(std::initializer_list<value_type> il) {
+		clear();
+		_insert_byiterator(before_begin(), il.begin(), il.end());
+	}
+
+	template <typename... Args>
+	void emplace_front(Args&&... args) {
+		value_type val(args...);
+		_insert_bynvals(before_begin(), 1, val);
+	}
+
+	void push_front(const value_type &val) {
+		_insert_bynvals(before_begin(), 1, val);
+	}
+
+	void pop_front() {
+		erase_after(before_begin());
+	}
+
+	template <typename... Args>
+	iterator emplace_after(const_iterator position, Args&&... args) {
+		value_type val(args...);
+		return _insert_bynvals(position, 1, val);
+	}
+
+	iterator insert_after(const_iterator position, const value_type &val) {
+		return _insert_bynvals(position, 1, val);
+	}
+
+	iterator insert_after(const_iterator position, size_type n, const value_type &val) {
+		return _insert_bynvals(position, n, val);
+	}
+
+	template <typename InputIterator>
+	iterator insert_after(const_iterator position, InputIterator first, InputIterator last) {
+		return _insert_aux(position, first, last, typename std::is_integral<InputIterator>::type());
+	}
+
+	iterator insert_after(const_iterator position, std::initializer_list<value_type> il) {
+		return _insert_byiterator(position, il.begin(), il.end());
+	}
+
+	iterator erase_after(const_iterator position) {
+		link_type pos = position._ptr;
+		link_type erased = pos->_next;
+		if (!erased)
+			throw std::exception("");
+		pos->_next = erased->_next;
+		_alloc.destroy(erased);
+		_alloc.deallocate(erased, 1);
+		return pos->_next;
+	}
+
+	//erases the open range (first, last)
+	iterator erase_after(const_iterator first, const_iterator last) {
+		link_type firstPos = first._ptr;
+		link_type lastPos = last._ptr;
+		link_type it = firstPos->_next;
+		firstPos->_next = lastPos;
+		while (it != lastPos) {
+			link_type next = it->_next;
+			_alloc.destroy(it);
+			_alloc.deallocate(it, 1);
+			it = next;
+		}
+		return lastPos;
+	}
+
+	void swap(ForwardList &x) {
+		std::swap(_blankNode, x._blankNode);
+		std::swap(_alloc, x._alloc);
+	}
+
+	void resize(size_type n) {
+		resize(n, value_type());
+	}
+
+	void resize(size_type n, const value_type &val) {
+		link_type pos = _blankNode;
+		while (n && pos->_next) {
+			pos = pos->_next;
+			--n;
+		}
+		if (pos->_next)
+			erase_after(pos, nullptr);
+		else
+			_insert_bynvals(pos, n, val);
+	}
+
+	void clear() noexcept {
+		if (!empty())
+			_clear_aux(std::integral_constant<bool, std::is_trivially_destructible<value_type>::value && has_deallocate_chain<allocator_type>::value>());
+		_blankNode->_next = nullptr;
+	}
+
+	void splice_after(const_iterator position, ForwardList &x) {
+		if (this == &x || x.empty())
+			return;
+		splice_after(position, x, x.before_begin(), nullptr);
+	}
+
+	//moves the element after i
+	void splice_after(const_iterator position, ForwardList &x, const_iterator i) {
+		link_type pos = position._ptr;
+		link_type before = i._ptr;
+		if (pos == before || pos == before->_next)
+			return;
+		link_type moved = before->_next;
+		before->_next = moved->_next;
+		moved->_next = pos->_next;
+		pos->_next = moved;
+	}
+
+	//moves the open range (first, last)
+	void splice_after(const_iterator position, ForwardList &x, const_iterator first, const_iterator last) {
+		link_type pos = position._ptr;
+		link_type before = first._ptr;
+		link_type lastPos = last._ptr;
+		if (before->_next == lastPos)
+			return;
+		link_type tail = before;
+		while (tail->_next != lastPos)
+			tail = tail->_next;
+		link_type moved = before->_next;
+		before->_next = lastPos;
+		tail->_next = pos->_next;
+		pos->_next = moved;
+	}
+
+	void remove(const value_type &val) {
+		remove_if([&val](const value_type &v)->bool {return val == v; });
+	}
+
+	template<typename Predicate>
+	void remove_if(Predicate pred) {
+		link_type pre = _blankNode;
+		while (pre->_next) {
+			if (pred(pre->_next->_data))
+				erase_after(pre);
+			else
+				pre = pre->_next;
+		}
+	}
+
+	void unique() {
+		unique([](const value_type &v1, const value_type &v2)->bool {return v1 == v2; });
+	}
+
+	template <typename BinaryPredicate>
+	void unique(BinaryPredicate binary_pred) {
+		link_type kept = _blankNode->_next;
+		if (!kept)
+			return;
+		while (kept->_next) {
+			if (binary_pred(kept->_next->_data, kept->_data))
+				erase_after(kept);
+			else
+				kept = kept->_next;
+		}
+	}
+
+	void merge(ForwardList &x) {
+		merge(x, std::less<>());
+	}
+
+	template<typename Compare>
+	void merge(ForwardList &x, Compare comp) {
+		if (this == &x || x.empty())
+			return;
+		_blankNode->_next = _blankNode->_next ? _merge_runs(_blankNode->_next, x._blankNode->_next, comp) : x._blankNode->_next;
+		x._blankNode->_next = nullptr;
+	}
+
+	void sort() {
+		sort(std::less<>());
+	}
+
+	template<typename Compare>
+	void sort(Compare comp) {
+		//bottom-up merge: bins[i] is empty or a sorted run of 2^i nodes
+		link_type bins[sizeof(size_type) * 8] = {};
+		link_type cur = _blankNode->_next;
+		while (cur) {
+			link_type carry = cur;
+			cur = cur->_next;
+			carry->_next = nullptr;
+			size_type i = 0;
+			for (; bins[i]; ++i) {
+				carry = _merge_runs(bins[i], carry, comp);
+				bins[i] = nullptr;
+			}
+			bins[i] = carry;
+		}
+		link_type sorted = nullptr;
+		for (size_type i = 0; i < sizeof(size_type) * 8; ++i)
+			if (bins[i])
+				sorted = sorted ? _merge_runs(bins[i], sorted, comp) : bins[i];
+		_blankNode->_next = sorted;
+	}
+
+	void reverse() {
+		link_type reversed = nullptr;
+		link_type cur = _blankNode->_next;
+		while (cur) {
+			link_type next = cur->_next;
+			cur->_next = reversed;
+			reversed = cur;
+			cur = next;
+		}
+		_blankNode->_next = reversed;
+	}
+
+	allocator_type get_allocator()const {
+		return _alloc;
+	}
+private:
+	void _init_blanknode() {
+		_blankNode = _alloc.allocate(1);
+		_blankNode->_next = nullptr;
+	}
+
+	void _clear_aux(std::true_type) {
+		//nothing to destroy, hand the whole chain back to the pool at once
+		link_type tail = _blankNode->_next;
+		while (tail->_next)
+			tail = tail->_next;
+		_alloc.deallocate_chain(_blankNode->_next, tail);
+	}
+
+	void _clear_aux(std::false_type) {
+		erase_after(before_begin(), nullptr);
+	}
+
+	iterator _insert_aux(const_iterator position, size_type n, const value_type &val, std::true_type) {
+		return _insert_bynvals(position, n, val);
+	}
+
+	template<typename InputIterator>
+	iterator _insert_aux(const_iterator position, InputIterator first, InputIterator last, std::false_type) {
+		return _insert_byiterator(position, first, last);
+	}
+
+	//both return the last inserted position, or position itself when nothing was inserted
+	iterator _insert_bynvals(const_iterator position, size_type n, const value_type &val) {
+		link_type backIt = position._ptr;
+		link_type after = backIt->_next;
+		while (n--) {
+			link_type frontIt = _alloc.allocate(1);
+			_alloc.construct(frontIt, val);
+			backIt->_next = frontIt;
+			backIt = frontIt;
+		}
+		backIt->_next = after;
+		return backIt;
+	}
+
+	template<typename InputIterator>
+	iterator _insert_byiterator(const_iterator position, InputIterator first, InputIterator last) {
+		link_type backIt = position._ptr;
+		link_type after = backIt->_next;
+		while (first != last) {
+			link_type frontIt = _alloc.allocate(1);
+			_alloc.construct(frontIt, *first++);
+			backIt->_next = frontIt;
+			backIt = frontIt;
+		}
+		backIt->_next = after;
+		return backIt;
+	}
+
+	//first holds the earlier elements, so ties keep their order
+	template<typename Compare>
+	link_type _merge_runs(link_type first, link_type second, Compare &comp) {
+		link_type head = nullptr;
+		link_type *tail = &head;
+		while (first && second) {
+			if (comp(second->_data, first->_data)) {
+				*tail = second;
+				tail = &second->_next;
+				second = second->_next;
+			}
+			else {
+				*tail = first;
+				tail = &first->_next;
+				first = first->_next;
+			}
+		}
+		*tail = first ? first : second;
+		return head;
+	}
+};
+
+#endif // !FORWARDLIST_H
\ No newline at end of file
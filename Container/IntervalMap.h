@@ -0,0 +1,192 @@
+#ifndef INTERVALMAP_H
+#define INTERVALMAP_H
+#include"Map.h"
+
+//Key is the half-open interval [first, second). _maxEnd is the largest end in the subtree, which lets a search
+//skip every subtree that ends before the query starts.
+template<typename Point, typename V>
+class interval_RBtree_node {
+public:
+	typedef bool                                        color_type;
+	typedef interval_RBtree_node*                       link_type;
+	typedef std::pair<const std::pair<Point, Point>, V> value_type;
+
+	value_type _value;
+	color_type _color;
+	link_type _parent;
+	link_type _left;
+	link_type _right;
+	Point _maxEnd;
+
+	interval_RBtree_node(const value_type &val, link_type parent = nullptr, link_type left = nullptr, link_type right = nullptr, color_type color = RED) \
+		:_value(val), _parent(parent), _left(left), _right(right), _color(color), _maxEnd(val.first.second) {};
+
+	template<typename... Args>
+	interval_RBtree_node(in_place_node_t, Args&&... args) \
+		:_value(std::forward<Args>(args)...), _parent(nullptr), _left(nullptr), _right(nullptr), _color(RED), _maxEnd(_value.first.second) {};
+
+	link_type parent()const {
+		return _parent;
+	}
+
+	void set_parent(link_type parent) {
+		_parent = parent;
+	}
+
+	color_type color()const {
+		return _color;
+	}
+
+	void set_color(color_type color) {
+		_color = color;
+	}
+
+	void augment() {
+		_maxEnd = _value.first.second;
+		if (_left && _maxEnd < _left->_maxEnd)
+			_maxEnd = _left->_maxEnd;
+		if (_right && _maxEnd < _right->_maxEnd)
+			_maxEnd = _right->_maxEnd;
+	}
+};
+
+template<typename Point, typename V>
+class pool_link<interval_RBtree_node<Point, V>> {
+public:
+	interval_RBtree_node<Point, V>*& operator()(interval_RBtree_node<Point, V> *p)const {
+		return p->_right;
+	}
+};
+
+//Intervals ordered by (start, end), one value per distinct interval. Each node keeps the largest end in its subtree,
+//so finding one overlap is O(log n) and reporting all k overlaps is O(k log(n/k)), not O(log n + k).
+template<typename Point, typename V, typename Alloc = std::allocator<interval_RBtree_node<Point, V>>>
+class IntervalMap {
+public:
+	typedef Point                                                                                  point_type;
+	typedef std::pair<Point, Point>                                                                key_type;
+	typedef V                                                                                      mapped_type;
+	typedef std::pair<const key_type, V>                                                           value_type;
+	typedef Alloc                                                                                  allocator_type;
+	typedef typename Alloc::value_type                                                             node_type;
+	typedef rb_tree_iterator<value_type, value_type&, value_type*, node_type>                      iterator;
+	typedef const_rb_tree_iterator<value_type, value_type&, value_type*, node_type>                const_iterator;
+	typedef size_t                                                                                 size_type;
+	typedef RBtree<key_type, value_type, select1st<const key_type, V>, std::less<key_type>, Alloc> tree_type;
+	typedef typename tree_type::link_type                                                          link_type;
+private:
+	tree_type _tree;
+public:
+	explicit IntervalMap(const allocator_type &alloc = allocator_type()) :_tree(std::less<key_type>(), alloc) {};
+
+	IntervalMap(const IntervalMap &x) :_tree(x._tree, false) {};
+
+	IntervalMap& operator=(const IntervalMap &x) {
+		_tree.assign(x._tree, false);
+		return *this;
+	}
+
+	iterator begin()const {
+		return _tree.begin();
+	}
+
+	iterator end()const {
+		return _tree.end();
+	}
+
+	bool empty()const {
+		return _tree.empty();
+	}
+
+	size_type size()const {
+		return _tree.size();
+	}
+
+	std::pair<iterator, bool> insert(const Point &lo, const Point &hi, const mapped_type &val) {
+		return _tree.insert_unique(value_type(key_type(lo, hi), val));
+	}
+
+	std::pair<iterator, bool> insert(const value_type &val) {
+		return _tree.insert_unique(val);
+	}
+
+	iterator erase(const_iterator position) {
+		return _tree.erase(position);
+	}
+
+	size_type erase(const Point &lo, const Point &hi) {
+		return _tree.erase(key_type(lo, hi));
+	}
+
+	void clear() {
+		_tree.clear();
+	}
+
+	void swap(IntervalMap &x) {
+		_tree.swap(x._tree);
+	}
+
+	iterator find(const Point &lo, const Point &hi)const {
+		return _tree.find(key_type(lo, hi));
+	}
+
+	//one interval containing p, end() if none; O(log n)
+	iterator find_overlap(const Point &p)const {
+		return _find_overlap(p, p, true);
+	}
+
+	//one interval overlapping [lo, hi), end() if none; O(log n)
+	iterator find_overlap(const Point &lo, const Point &hi)const {
+		return _find_overlap(lo, hi, false);
+	}
+
+	//writes an iterator to every interval containing p, in key order
+	template<typename OutputIterator>
+	OutputIterator overlapping(const Point &p, OutputIterator out)const {
+		return _collect(_tree.root(), p, p, true, out);
+	}
+
+	//writes an iterator to every interval overlapping [lo, hi), in key order
+	template<typename OutputIterator>
+	OutputIterator overlapping(const Point &lo, const Point &hi, OutputIterator out)const {
+		return _collect(_tree.root(), lo, hi, false, out);
+	}
+private:
+	//closed turns the query into [lo, hi], which is how a point p = [p, p] is asked for
+	bool _starts_before(const key_type &key, const Point &hi, bool closed)const {
+		return closed ? !(hi < key.first) : key.first < hi;
+	}
+
+	//Goes left whenever the left subtree reaches past lo: if nothing there overlaps, nothing on the right can either,
+	//since every start on the right is at least as large.
+	iterator _find_overlap(const Point &lo, const Point &hi, bool closed)const {
+		link_type node = _tree.root();
+		while (node) {
+			const key_type &key = node->_value.first;
+			if (lo < key.second && _starts_before(key, hi, closed))
+				return node;
+			if (node->_left && lo < node->_left->_maxEnd)
+				node = node->_left;
+			else
+				node = node->_right;
+		}
+		return end();
+	}
+
+	//in-order walk that prunes subtrees ending at or before lo and stops at the first start past hi
+	template<typename OutputIterator>
+	OutputIterator _collect(link_type node, const Point &lo, const Point &hi, bool closed, OutputIterator out)const {
+		while (node && lo < node->_maxEnd) {
+			out = _collect(node->_left, lo, hi, closed, out);
+			const key_type &key = node->_value.first;
+			if (!_starts_before(key, hi, closed))
+				break;
+			if (lo < key.second)
+				*out++ = iterator(node);
+			node = node->_right;
+		}
+		return out;
+	}
+};
+
+#endif // !INTERVALMAP_H
\ No newline at end of file
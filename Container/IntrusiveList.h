@@ -0,0 +1,576 @@
+#ifndef INTRUSIVELIST_H
+#define INTRUSIVELIST_H
+#include<iterator>
+#include<type_traits>
+#include<functional>
+
+struct list_hook {
+	list_hook *_next;
+	list_hook *_pre;
+
+	list_hook() :_next(nullptr), _pre(nullptr) {};
+
+	//a hook belongs to the object it is embedded in, copying the object must not copy its links
+	list_hook(const list_hook&) :_next(nullptr), _pre(nullptr) {};
+
+	list_hook& operator=(const list_hook&) {
+		return *this;
+	}
+
+	bool is_linked()const {
+		return _next != nullptr;
+	}
+};
+
+template<typename T, list_hook T::*Hook>
+class IntrusiveList;
+
+template<typename T, list_hook T::*Hook>
+class intrusive_list_iterator {
+public:
+	typedef T                               value_type;
+	typedef ptrdiff_t                       difference_type;
+	typedef T&                              reference;
+	typedef T*                              pointer;
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef list_hook*                      link_type;
+protected:
+	link_type _ptr;
+	friend class IntrusiveList<T, Hook>;
+public:
+	intrusive_list_iterator() :_ptr(nullptr) {};
+
+	intrusive_list_iterator(link_type ptr) :_ptr(ptr) {};
+
+	intrusive_list_iterator(const intrusive_list_iterator &x) :_ptr(x._ptr) {};
+
+	intrusive_list_iterator& operator=(const intrusive_list_iterator &x) {
+		_ptr = x._ptr;
+		return *this;
+	}
+
+	bool operator==(const intrusive_list_iterator &x)const {
+		return _ptr == x._ptr;
+	}
+
+	bool operator!=(const intrusive_list_iterator &x)const {
+		return _ptr != x._ptr;
+	}
+
+	reference operator*()const {
+		return *IntrusiveList<T, Hook>::_owner(_ptr);
+	}
+
+	pointer operator->()const {
+		return IntrusiveList<T, Hook>::_owner(_ptr);
+	}
+
+	intrusive_list_iterator& operator++() {
+		_ptr = _ptr->_next;
+		return *this;
+	}
+
+	intrusive_list_iterator operator++(int) {
+		intrusive_list_iterator retIt(_ptr);
+		_ptr = _ptr->_next;
+		return retIt;
+	}
+
+	intrusive_list_iterator& operator--() {
+		_ptr = _ptr->_pre;
+		return *this;
+	}
+
+	intrusive_list_iterator operator--(int) {
+		intrusive_list_iterator retIt(_ptr);
+		_ptr = _ptr->_pre;
+		return retIt;
+	}
+
+	link_type Ptr()const {
+		return _ptr;
+	}
+};
+
+template<typename T, list_hook T::*Hook>
+class const_intrusive_list_iterator :public intrusive_list_iterator<T, Hook> {
+	friend class IntrusiveList<T, Hook>;
+public:
+	typedef T                                 value_type;
+	typedef ptrdiff_t                         difference_type;
+	typedef const T&                          reference;
+	typedef const T*                          pointer;
+	typedef std::bidirectional_iterator_tag   iterator_category;
+	typedef list_hook*                        link_type;
+	typedef intrusive_list_iterator<T, Hook>  parent_iterator;
+public:
+	const_intrusive_list_iterator() :parent_iterator() {};
+
+	const_intrusive_list_iterator(link_type ptr) :parent_iterator(ptr) {};
+
+	const_intrusive_list_iterator(const parent_iterator &x) :parent_iterator(x) {};
+
+	reference operator*()const {
+		return *IntrusiveList<T, Hook>::_owner(this->_ptr);
+	}
+
+	pointer operator->()const {
+		return IntrusiveList<T, Hook>::_owner(this->_ptr);
+	}
+
+	const_intrusive_list_iterator& operator++() {
+		this->_ptr = this->_ptr->_next;
+		return *this;
+	}
+
+	const_intrusive_list_iterator operator++(int) {
+		const_intrusive_list_iterator retIt(this->_ptr);
+		this->_ptr = this->_ptr->_next;
+		return retIt;
+	}
+
+	const_intrusive_list_iterator& operator--() {
+		this->_ptr = this->_ptr->_pre;
+		return *this;
+	}
+
+	const_intrusive_list_iterator operator--(int) {
+		const_intrusive_list_iterator retIt(this->_ptr);
+		this->_ptr = this->_ptr->_pre;
+		return retIt;
+	}
+};
+
+//Links objects through their embedded list_hook member, nothing is allocated or destroyed: the objects stay owned by the caller.
+template<typename T, list_hook T::*Hook>
+class IntrusiveList {
+public:
+	typedef size_t                                  size_type;
+	typedef ptrdiff_t                               difference_type;
+	typedef T                                       value_type;
+	typedef T&                                      reference;
+	typedef const T&                                const_reference;
+	typedef list_hook*                              link_type;
+	typedef T*                                      pointer;
+	typedef const T*                                const_pointer;
+	typedef intrusive_list_iterator<T, Hook>        iterator;
+	typedef const_intrusive_list_iterator<T, Hook>  const_iterator;
+	typedef std::reverse_iterator<iterator>         reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+	friend class intrusive_list_iterator<T, Hook>;
+	friend class const_intrusive_list_iterator<T, Hook>;
+private:
+	list_hook _blankNode;
+	//_unknownSize after a cross-list splice without a count, size() recounts on demand
+	mutable size_type _size;
+public:
+	IntrusiveList() :_size(0) {
+		_blankNode._next = &_blankNode;
+		_blankNode._pre = &_blankNode;
+	}
+
+	IntrusiveList(const IntrusiveList&) = delete;
+
+	IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+	~IntrusiveList() {
+		clear();
+	}
+
+	iterator begin() {
+		return _blankNode._next;
+	}
+
+	const_iterator begin()const {
+		return _blankNode._next;
+	}
+
+	iterator end() {
+		return &_blankNode;
+	}
+
+	const_iterator end()const {
+		return const_cast<link_type>(&_blankNode);
+	}
+
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin()const {
+		return const_reverse_iterator(end());
+	}
+
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend()const {
+		return const_reverse_iterator(begin());
+	}
+
+	const_iterator cbegin()const {
+		return begin();
+	}
+
+	const_iterator cend()const {
+		return end();
+	}
+
+	bool empty()const {
+		return _blankNode._next == &_blankNode;
+	}
+
+	size_type size()const {
+		if (_size == _unknownSize)
+			_size = std::distance(begin(), end());
+		return _size;
+	}
+
+	reference front() {
+		if (empty())
+			throw std::exception("");
+		return *begin();
+	}
+
+	const_reference front()const {
+		if (empty())
+			throw std::exception("");
+		return *begin();
+	}
+
+	reference back() {
+		if (empty())
+			throw std::exception("");
+		return *(--end());
+	}
+
+	const_reference back()const {
+		if (empty())
+			throw std::exception("");
+		return *(--end());
+	}
+
+	//O(1) position of an object that is known to be in this list
+	static iterator iterator_to(reference val) {
+		return &(val.*Hook);
+	}
+
+	static const_iterator iterator_to(const_reference val) {
+		return const_cast<link_type>(&(val.*Hook));
+	}
+
+	void push_front(reference val) {
+		insert(begin(), val);
+	}
+
+	void pop_front() {
+		erase(begin());
+	}
+
+	void push_back(reference val) {
+		insert(end(), val);
+	}
+
+	void pop_back() {
+		erase(_blankNode._pre);
+	}
+
+	iterator insert(const_iterator position, reference val) {
+		link_type node = &(val.*Hook);
+		if (node->is_linked())
+			throw std::exception("");
+		_hook_offset(&val);
+		link_type pos = position._ptr;
+		node->_next = pos;
+		node->_pre = pos->_pre;
+		pos->_pre->_next = node;
+		pos->_pre = node;
+		_adjust_size(1);
+		return node;
+	}
+
+	template<typename InputIterator>
+	void insert(const_iterator position, InputIterator first, InputIterator last) {
+		while (first != last) {
+			insert(position, *first);
+			++first;
+		}
+	}
+
+	iterator erase(const_iterator position) {
+		link_type pos = position._ptr;
+		if (pos == &_blankNode)
+			throw std::exception("");
+		link_type ret = pos->_next;
+		pos->_pre->_next = pos->_next;
+		pos->_next->_pre = pos->_pre;
+		pos->_next = pos->_pre = nullptr;
+		_adjust_size(-1);
+		return ret;
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		link_type firstPos = first._ptr;
+		link_type lastPos = last._ptr;
+		firstPos->_pre->_next = lastPos;
+		lastPos->_pre = firstPos->_pre;
+		link_type it;
+		while (firstPos != lastPos) {
+			it = firstPos;
+			firstPos = firstPos->_next;
+			it->_next = it->_pre = nullptr;
+			_adjust_size(-1);
+		}
+		return lastPos;
+	}
+
+	void swap(IntrusiveList &x) {
+		if (this == &x)
+			return;
+		IntrusiveList tempList;
+		tempList.splice(tempList.end(), *this);
+		splice(end(), x);
+		x.splice(x.end(), tempList);
+	}
+
+	void clear() noexcept {
+		link_type curIt = _blankNode._next;
+		link_type preIt;
+		while (curIt != &_blankNode) {
+			preIt = curIt;
+			curIt = curIt->_next;
+			preIt->_next = preIt->_pre = nullptr;
+		}
+		_blankNode._next = &_blankNode;
+		_blankNode._pre = &_blankNode;
+		_size = 0;
+	}
+
+	void splice(const_iterator position, IntrusiveList &x) {
+		if (this == &x || x.empty())
+			return;
+		_size = _size == _unknownSize || x._size == _unknownSize ? _unknownSize : _size + x._size;
+		x._size = 0;
+		_transfer(position, x.begin(), x.end());
+	}
+
+	void splice(const_iterator position, IntrusiveList &x, const_iterator i) {
+		const_iterator iNext(i);
+		++iNext;
+		if (position == i)
+			return;
+		splice(position, x, i, iNext, 1);
+	}
+
+	//across lists the moved length is not walked, both sizes are recounted lazily by the next size()
+	void splice(const_iterator position, IntrusiveList &x, const_iterator first, const_iterator last) {
+		if (position == last || first == last)
+			return;
+		if (this != &x)
+			_size = x._size = _unknownSize;
+		_transfer(position, first, last);
+	}
+
+	//n is the length of [first, last), it keeps both sizes exact; it is ignored within one list
+	void splice(const_iterator position, IntrusiveList &x, const_iterator first, const_iterator last, size_type n) {
+		if (position == last || first == last)
+			return;
+		if (this != &x) {
+			x._adjust_size(-difference_type(n));
+			_adjust_size(n);
+		}
+		_transfer(position, first, last);
+	}
+
+	void remove(const value_type &val) {
+		remove_if([&val](const value_type &v)->bool {return val == v; });
+	}
+
+	template<typename Predicate>
+	void remove_if(Predicate pred) {
+		iterator it = begin();
+		while (it != end()) {
+			if (pred(*it))
+				it = erase(it);
+			else
+				++it;
+		}
+	}
+
+	void unique() {
+		unique([](const value_type &v1, const value_type &v2)->bool {return v1 == v2; });
+	}
+
+	template <typename BinaryPredicate>
+	void unique(BinaryPredicate binary_pred) {
+		if (empty())
+			return;
+		iterator slow = begin();
+		iterator fast = slow;
+		++fast;
+		while (fast != end()) {
+			if (binary_pred(*fast, *slow))
+				fast = erase(fast);
+			else
+				slow = fast++;
+		}
+	}
+
+	void merge(IntrusiveList &x) {
+		merge(x, std::less<>());
+	}
+
+	template<typename Compare>
+	void merge(IntrusiveList &x, Compare comp) {
+		if (this == &x || x.empty())
+			return;
+		if (empty()) {
+			splice(end(), x);
+			return;
+		}
+		link_type first = _detach_run();
+		link_type second = x._detach_run();
+		_size = _size == _unknownSize || x._size == _unknownSize ? _unknownSize : _size + x._size;
+		x._size = 0;
+		_attach_run(_merge_runs(first, second, comp));
+	}
+
+	void sort() {
+		sort(std::less<>());
+	}
+
+	template<typename Compare>
+	void sort(Compare comp) {
+		if (empty() || _blankNode._next == _blankNode._pre)
+			return;
+		//bottom-up merge: bins[i] is empty or a sorted run of 2^i nodes
+		link_type bins[sizeof(size_type) * 8] = {};
+		link_type cur = _blankNode._next;
+		_blankNode._pre->_next = nullptr;
+		while (cur) {
+			link_type carry = cur;
+			cur = cur->_next;
+			carry->_next = nullptr;
+			carry->_pre = carry;
+			size_type i = 0;
+			for (; bins[i]; ++i) {
+				carry = _merge_runs(bins[i], carry, comp);
+				bins[i] = nullptr;
+			}
+			bins[i] = carry;
+		}
+		link_type sorted = nullptr;
+		for (size_type i = 0; i < sizeof(size_type) * 8; ++i)
+			if (bins[i])
+				sorted = sorted ? _merge_runs(bins[i], sorted, comp) : bins[i];
+		_attach_run(sorted);
+	}
+
+	void reverse() {
+		link_type curNode = &_blankNode;
+		while (true) {
+			link_type nextNode = curNode->_next;
+			curNode->_next = curNode->_pre;
+			curNode->_pre = nextNode;
+			if (nextNode == &_blankNode)
+				break;
+			curNode = nextNode;
+		}
+	}
+private:
+	static const size_type _unknownSize = size_type(-1);
+
+	//where the hook sits inside T, measured on the first object insert links, which is a real T; every hook that
+	//reaches _owner was linked by insert, so the offset is known by then
+	static ptrdiff_t _hook_offset(const T *val = nullptr) {
+		static const ptrdiff_t offset = reinterpret_cast<const char*>(&(val->*Hook)) - reinterpret_cast<const char*>(val);
+		return offset;
+	}
+
+	//checked here rather than at class scope, so T may still be incomplete where the list is declared
+	static T* _owner(link_type hook) {
+		static_assert(std::is_standard_layout<T>::value, "IntrusiveList needs a standard-layout T to find the owner of a hook");
+		return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - _hook_offset());
+	}
+
+	void _adjust_size(difference_type n) {
+		if (_size != _unknownSize)
+			_size += n;
+	}
+
+	void _transfer(const_iterator position, const_iterator first, const_iterator last) {
+		link_type firstPos = first._ptr, lastPos = last._ptr;
+		link_type beforeLastPos = lastPos->_pre;
+		firstPos->_pre->_next = lastPos;
+		lastPos->_pre = firstPos->_pre;
+		link_type insertedPos = position._ptr;
+		firstPos->_pre = insertedPos->_pre;
+		insertedPos->_pre->_next = firstPos;
+		beforeLastPos->_next = insertedPos;
+		insertedPos->_pre = beforeLastPos;
+	}
+
+	//turns the non-empty list into a run for _merge_runs and leaves the sentinel empty
+	link_type _detach_run() {
+		link_type head = _blankNode._next;
+		head->_pre = _blankNode._pre;
+		_blankNode._pre->_next = nullptr;
+		_blankNode._next = _blankNode._pre = &_blankNode;
+		return head;
+	}
+
+	void _attach_run(link_type head) {
+		_blankNode._pre = head->_pre;
+		head->_pre->_next = &_blankNode;
+		_blankNode._next = head;
+		head->_pre = &_blankNode;
+	}
+
+	//a run is a null-terminated chain whose head->_pre points at its tail,
+	//first holds the earlier elements so ties keep their order
+	template<typename Compare>
+	static link_type _merge_runs(link_type first, link_type second, Compare &comp) {
+		link_type firstTail = first->_pre;
+		link_type secondTail = second->_pre;
+		link_type head;
+		if (comp(*_owner(second), *_owner(first))) {
+			head = second;
+			second = second->_next;
+		}
+		else {
+			head = first;
+			first = first->_next;
+		}
+		link_type tail = head;
+		while (first && second) {
+			if (comp(*_owner(second), *_owner(first))) {
+				tail->_next = second;
+				second->_pre = tail;
+				tail = second;
+				second = second->_next;
+			}
+			else {
+				tail->_next = first;
+				first->_pre = tail;
+				tail = first;
+				first = first->_next;
+			}
+		}
+		if (first) {
+			tail->_next = first;
+			first->_pre = tail;
+			tail = firstTail;
+		}
+		else {
+			tail->_next = second;
+			second->_pre = tail;
+			tail = secondTail;
+		}
+		head->_pre = tail;
+		return head;
+	}
+};
+
+#endif // !INTRUSIVELIST_H
\ No newline at end of file
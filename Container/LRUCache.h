@@ -0,0 +1,205 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+#include<memory>
+#include<functional>
+#include<utility>
+#include"List.h"
+#include"Vector.h"
+
+template<typename K, typename V>
+struct lru_entry {
+	K _key;
+	V _value;
+	size_t _weight;
+	//next node in the same hash bucket
+	list_node<lru_entry> *_hashNext;
+
+	lru_entry(const K &key = K(), const V &value = V(), size_t weight = 1) :_key(key), _value(value), _weight(weight), _hashNext(nullptr) {};
+};
+
+//every entry counts 1, so the capacity is an entry count
+template<typename K, typename V>
+class lru_unit_weight {
+public:
+	size_t operator()(const K&, const V&)const {
+		return 1;
+	}
+};
+
+//Recency order lives in a List (front is the most recently used), the hash index chains the list nodes themselves,
+//so a hit is one bucket walk plus one splice and there is no separate index allocation per entry.
+template<typename K, typename V, typename Hash = std::hash<K>, typename Weigher = lru_unit_weight<K, V>,
+	typename KeyEqual = std::equal_to<K>, typename Alloc = std::allocator<list_node<lru_entry<K, V>>>>
+class LRUCache {
+public:
+	typedef K                                             key_type;
+	typedef V                                             mapped_type;
+	typedef lru_entry<K, V>                               value_type;
+	typedef Alloc                                         allocator_type;
+	typedef size_t                                        size_type;
+	typedef List<value_type, Alloc>                       list_type;
+	typedef typename list_type::link_type                 link_type;
+	typedef typename list_type::const_iterator            const_iterator;
+private:
+	list_type _list;
+	Vector<link_type> _buckets;
+	size_type _capacity;
+	size_type _weight;
+	size_type _hits;
+	size_type _misses;
+	Hash _hash;
+	KeyEqual _equal;
+	Weigher _weigher;
+public:
+	explicit LRUCache(size_type capacity, const Hash &hash = Hash(), const Weigher &weigher = Weigher(),
+		const KeyEqual &equal = KeyEqual(), const allocator_type &alloc = allocator_type())
+		:_list(alloc), _buckets(16, nullptr), _capacity(capacity), _weight(0), _hits(0), _misses(0), _hash(hash), _equal(equal), _weigher(weigher) {};
+
+	LRUCache(const LRUCache&) = delete;
+
+	LRUCache& operator=(const LRUCache&) = delete;
+
+	const_iterator begin()const {
+		return _list.begin();
+	}
+
+	const_iterator end()const {
+		return _list.end();
+	}
+
+	size_type size()const {
+		return _list.size();
+	}
+
+	bool empty()const {
+		return _list.empty();
+	}
+
+	size_type capacity()const {
+		return _capacity;
+	}
+
+	size_type weight()const {
+		return _weight;
+	}
+
+	size_type hits()const {
+		return _hits;
+	}
+
+	size_type misses()const {
+		return _misses;
+	}
+
+	void reset_stats() {
+		_hits = _misses = 0;
+	}
+
+	//marks the entry most recently used, nullptr on a miss
+	mapped_type* get(const key_type &key) {
+		link_type node = _find(key);
+		if (!node) {
+			++_misses;
+			return nullptr;
+		}
+		++_hits;
+		_touch(node);
+		return &node->_data._value;
+	}
+
+	//no effect on recency or statistics
+	const mapped_type* peek(const key_type &key)const {
+		link_type node = _find(key);
+		return node ? &node->_data._value : nullptr;
+	}
+
+	bool contains(const key_type &key)const {
+		return _find(key) != nullptr;
+	}
+
+	//evicts from the cold end until the total weight fits, which can include the new entry itself
+	void put(const key_type &key, const mapped_type &value) {
+		size_type weight = _weigher(key, value);
+		link_type node = _find(key);
+		if (node) {
+			node->_data._value = value;
+			_weight = _weight - node->_data._weight + weight;
+			node->_data._weight = weight;
+			_touch(node);
+		}
+		else {
+			if (_list.size() >= _buckets.size())
+				_rehash(_buckets.size() * 2);
+			_list.push_front(value_type(key, value, weight));
+			node = _list.begin().Ptr();
+			link_type &bucket = _bucket(key);
+			node->_data._hashNext = bucket;
+			bucket = node;
+			_weight += weight;
+		}
+		_evict();
+	}
+
+	bool erase(const key_type &key) {
+		link_type node = _find(key);
+		if (!node)
+			return false;
+		_erase_node(node);
+		return true;
+	}
+
+	void set_capacity(size_type capacity) {
+		_capacity = capacity;
+		_evict();
+	}
+
+	void clear() {
+		_list.clear();
+		_buckets.assign(_buckets.size(), nullptr);
+		_weight = 0;
+	}
+private:
+	link_type& _bucket(const key_type &key) {
+		return _buckets[_hash(key) & (_buckets.size() - 1)];
+	}
+
+	link_type _find(const key_type &key)const {
+		link_type node = _buckets[_hash(key) & (_buckets.size() - 1)];
+		while (node && !_equal(node->_data._key, key))
+			node = node->_data._hashNext;
+		return node;
+	}
+
+	void _touch(link_type node) {
+		if (node != _list.begin().Ptr())
+			_list.splice(_list.begin(), _list, node);
+	}
+
+	void _evict() {
+		while (_weight > _capacity && !_list.empty())
+			_erase_node((--_list.end()).Ptr());
+	}
+
+	void _erase_node(link_type node) {
+		link_type *link = &_bucket(node->_data._key);
+		while (*link != node)
+			link = &(*link)->_data._hashNext;
+		*link = node->_data._hashNext;
+		_weight -= node->_data._weight;
+		_list.erase(node);
+	}
+
+	//bucket count stays a power of two
+	void _rehash(size_type n) {
+		Vector<link_type> buckets(n, nullptr);
+		for (auto it = _list.begin(); it != _list.end(); ++it) {
+			link_type node = it.Ptr();
+			link_type &bucket = buckets[_hash(node->_data._key) & (n - 1)];
+			node->_data._hashNext = bucket;
+			bucket = node;
+		}
+		_buckets = std::move(buckets);
+	}
+};
+
+#endif // !LRUCACHE_H
\ No newline at end of file
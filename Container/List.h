@@ -4,6 +4,7 @@
 #include<initializer_list>
 #include<iterator>
 #include<type_traits>
+#include"Pool_allocator.h"
 
 template<typename T>
 struct list_node {
@@ -28,7 +29,7 @@ public:
 	typedef list_node<T>*                   link_type;
 protected:
 	mutable link_type _ptr;
-	friend class List<T>;
+	template<typename, typename> friend class List;
 public:
 	list_iterator() :_ptr(nullptr) {};
 
@@ -86,7 +87,7 @@ public:
 
 template<typename T>
 class const_list_iterator :public list_iterator<T> {
-	friend class List<T>;
+	template<typename, typename> friend class List;
 public:
 	typedef T                               value_type;
 	typedef ptrdiff_t                       difference_type;
@@ -150,6 +151,7 @@ class List {
 public:
 	typedef Alloc                                 allocator_type;
 	typedef size_t                                size_type;
+	typedef ptrdiff_t                             difference_type;
 	typedef T                                     value_type;
 	typedef T&                                    reference;
 	typedef const T&                              const_reference;
@@ -162,6 +164,8 @@ public:
 	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 private:
 	link_type _blankNode;
+	//_unknownSize after a cross-list splice without a count, size() recounts on demand
+	mutable size_type _size;
 	allocator_type _alloc;
 public:
 	explicit List(const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
@@ -184,7 +188,7 @@ public:
 		_construct_aux(first, last, std::is_integral<InputIterator>::type());
 	}
 
-	List(const List &x) {
+	List(const List &x) :_alloc(x._alloc) {
 		_init_blanknode();
 		_insert_byiterator(begin(), x.begin(), x.end());
 	}
@@ -264,7 +268,9 @@ public:
 	}
 
 	size_type size()const {
-		return std::distance(begin(), end());
+		if (_size == _unknownSize)
+			_size = std::distance(begin(), end());
+		return _size;
 	}
 
 	size_type max_size()const {
@@ -370,6 +376,7 @@ public:
 		pos->_next->_pre = pos->_pre;
 		_alloc.destroy(pos);
 		_alloc.deallocate(pos, 1);
+		_adjust_size(-1);
 		return ret;
 	}
 
@@ -384,6 +391,7 @@ public:
 			firstPos = firstPos->_next;
 			_alloc.destroy(it);
 			_alloc.deallocate(it, 1);
+			_adjust_size(-1);
 		}
 		return lastPos;
 	}
@@ -392,6 +400,10 @@ public:
 		link_type tempBlankNode = _blankNode;
 		_blankNode = x._blankNode;
 		x._blankNode = tempBlankNode;
+		size_type tempSize = _size;
+		_size = x._size;
+		x._size = tempSize;
+		std::swap(_alloc, x._alloc);
 	}
 
 	void resize(size_type n) {
@@ -399,7 +411,7 @@ public:
 	}
 
 	void resize(size_type n, const value_type &val) {
-		int s = size();
+		size_type s = size();
 		if (n < s) {
 			link_type pos = _blankNode->_next;
 			while (n--)
@@ -412,29 +424,19 @@ public:
 	}
 
 	void clear() noexcept {
-		link_type curIt = _blankNode->_next;
-		link_type preIt;
-		if (!std::is_trivially_destructible<value_type>::value) 
-			while (curIt != _blankNode) {
-				preIt = curIt;
-				curIt = curIt->_next;
-				_alloc.destroy(preIt);
-				_alloc.deallocate(preIt, 1);
-			}
-		else 
-			while (curIt != _blankNode) {
-				preIt = curIt;
-				curIt = curIt->_next;
-				_alloc.deallocate(preIt, 1);
-			}
+		if (!empty())
+			_clear_aux(std::integral_constant<bool, std::is_trivially_destructible<value_type>::value && has_deallocate_chain<allocator_type>::value>());
 		_blankNode->_next = _blankNode;
 		_blankNode->_pre = _blankNode;
+		_size = 0;
 	}
 
 	void splice(const_iterator position, List &x) {
-		if (this == &x)
+		if (this == &x || x.empty())
 			return;
-		splice(position, x, x.begin(), x.end());
+		_size = _size == _unknownSize || x._size == _unknownSize ? _unknownSize : _size + x._size;
+		x._size = 0;
+		_transfer(position, x.begin(), x.end());
 	}
 
 	void splice(const_iterator position, List &x, const_iterator i) {
@@ -442,24 +444,27 @@ public:
 		++iNext;
 		if (position == i)
 			return;
-		splice(position, x, i, iNext);
+		splice(position, x, i, iNext, 1);
 	}
 
+	//across lists the moved length is not walked, both sizes are recounted lazily by the next size()
 	void splice(const_iterator position, List &x, const_iterator first, const_iterator last) {
-		if (position != last) {
-			int n = std::distance(first, last);
-			if (n == 0)
-				return;
-			link_type firstPos = first._ptr, lastPos = last._ptr;
-			link_type beforeLastPos = lastPos->_pre;
-			firstPos->_pre->_next = lastPos;
-			lastPos->_pre = firstPos->_pre;
-			link_type insertedPos = position._ptr;
-			firstPos->_pre = insertedPos->_pre;
-			insertedPos->_pre->_next = firstPos;
-			beforeLastPos->_next = insertedPos;
-			insertedPos->_pre = beforeLastPos;
+		if (position == last || first == last)
+			return;
+		if (this != &x)
+			_size = x._size = _unknownSize;
+		_transfer(position, first, last);
+	}
+
+	//n is the length of [first, last), it keeps both sizes exact; it is ignored within one list
+	void splice(const_iterator position, List &x, const_iterator first, const_iterator last, size_type n) {
+		if (position == last || first == last)
+			return;
+		if (this != &x) {
+			x._adjust_size(-difference_type(n));
+			_adjust_size(n);
 		}
+		_transfer(position, first, last);
 	}
 
 	void remove(const value_type &val) {
@@ -542,8 +547,10 @@ public:
 		}
 		_alloc.deallocate(_blankNode, 1);
 		_blankNode = newBlankNode;
+		_size = _size == _unknownSize || x._size == _unknownSize ? _unknownSize : _size + x._size;
 		x._blankNode->_next = x._blankNode;
 		x._blankNode->_pre = x._blankNode;
+		x._size = 0;
 	}
 
 	void sort() {
@@ -552,7 +559,32 @@ public:
 
 	template<typename Compare>
 	void sort(Compare comp) {
-		_quicksort(_blankNode->_next, _blankNode, size(), comp);
+		if (size() < 2)
+			return;
+		//bottom-up merge: bins[i] is empty or a sorted run of 2^i nodes
+		link_type bins[sizeof(size_type) * 8] = {};
+		link_type cur = _blankNode->_next;
+		_blankNode->_pre->_next = nullptr;
+		while (cur) {
+			link_type carry = cur;
+			cur = cur->_next;
+			carry->_next = nullptr;
+			carry->_pre = carry;
+			size_type i = 0;
+			for (; bins[i]; ++i) {
+				carry = _merge_runs(bins[i], carry, comp);
+				bins[i] = nullptr;
+			}
+			bins[i] = carry;
+		}
+		link_type sorted = nullptr;
+		for (size_type i = 0; i < sizeof(size_type) * 8; ++i)
+			if (bins[i])
+				sorted = sorted ? _merge_runs(bins[i], sorted, comp) : bins[i];
+		_blankNode->_pre = sorted->_pre;
+		sorted->_pre->_next = _blankNode;
+		_blankNode->_next = sorted;
+		sorted->_pre = _blankNode;
 	}
 
 	void reverse() {
@@ -568,13 +600,56 @@ public:
 	}
 
 	allocator_type get_allocator() const {
-		return allocator_type();
+		return _alloc;
 	}
 private:
+	static const size_type _unknownSize = size_type(-1);
+
+	void _adjust_size(difference_type n) {
+		if (_size != _unknownSize)
+			_size += n;
+	}
+
+	void _transfer(const_iterator position, const_iterator first, const_iterator last) {
+		link_type firstPos = first._ptr, lastPos = last._ptr;
+		link_type beforeLastPos = lastPos->_pre;
+		firstPos->_pre->_next = lastPos;
+		lastPos->_pre = firstPos->_pre;
+		link_type insertedPos = position._ptr;
+		firstPos->_pre = insertedPos->_pre;
+		insertedPos->_pre->_next = firstPos;
+		beforeLastPos->_next = insertedPos;
+		insertedPos->_pre = beforeLastPos;
+	}
+
+	void _clear_aux(std::true_type) {
+		//nothing to destroy, hand the whole chain back to the pool at once
+		_alloc.deallocate_chain(_blankNode->_next, _blankNode->_pre);
+	}
+
+	void _clear_aux(std::false_type) {
+		link_type curIt = _blankNode->_next;
+		link_type preIt;
+		if (!std::is_trivially_destructible<value_type>::value) 
+			while (curIt != _blankNode) {
+				preIt = curIt;
+				curIt = curIt->_next;
+				_alloc.destroy(preIt);
+				_alloc.deallocate(preIt, 1);
+			}
+		else 
+			while (curIt != _blankNode) {
+				preIt = curIt;
+				curIt = curIt->_next;
+				_alloc.deallocate(preIt, 1);
+			}
+	}
+
 	void _init_blanknode() {
 		_blankNode = _alloc.allocate(1);
 		_blankNode->_next = _blankNode;
 		_blankNode->_pre = _blankNode;
+		_size = 0;
 	}
 
 	void _construct_aux(size_type n, const value_type &val, std::true_type) {
@@ -593,7 +668,7 @@ private:
 
 	template<typename InputIterator>
 	void _assign_aux(InputIterator first, InputIterator last, std::false_type) {
-		List tempList(first, last); 
+		List tempList(first, last, _alloc);
 		clear();
 		_insert_byiterator(begin(), tempList.begin(), tempList.end());
 	}
@@ -608,19 +683,20 @@ private:
 	}
 
 	iterator _insert_bynvals(const_iterator position,size_type n, const value_type &val) {
-		if (n == 0)
-			return nullptr;
-		link_type begin = _alloc.allocate(1);
-		_alloc.construct(begin, val);
-		link_type cur = begin;
-		while (--n) {
-			cur ->_next= _alloc.allocate(1);
-			_alloc.construct(cur->_next, val);
-			cur->_next->_pre = cur;
-			cur = cur->_next;
+		link_type beforePosition = position._ptr->_pre;
+		link_type backIt = beforePosition;
+		link_type frontIt;
+		_adjust_size(n);
+		while (n--) {
+			frontIt = _alloc.allocate(1);
+			_alloc.construct(frontIt, val);
+			backIt->_next = frontIt;
+			frontIt->_pre = backIt;
+			backIt = frontIt;
 		}
-		_insert_byiterator(position, iterator(begin), iterator(cur->_next));
-		return begin;
+		backIt->_next = position._ptr;
+		position._ptr->_pre = backIt;
+		return beforePosition->_next;
 	}
 
 	template<typename InputIterator>
@@ -634,41 +710,55 @@ private:
 			backIt->_next = frontIt;
 			frontIt->_pre = backIt;
 			backIt = frontIt;
+			_adjust_size(1);
 		}
 		backIt->_next = position._ptr;
 		position._ptr->_pre = backIt;
 		return beforePosition->_next;
 	}
 
+	//a run is a null-terminated chain whose head->_pre points at its tail,
+	//first holds the earlier elements so ties keep their order
 	template<typename Compare>
-	link_type _quicksort(link_type first, link_type last, size_type size, Compare comp) {
-		if (size < 2)
-			return first;
-		link_type mid = _advance(first, size >> 1);
-		first = _quicksort(first, mid, size >> 1, comp);
-		mid = _quicksort(mid, last, size - (size >> 1), comp);
-		link_type newFirst = first;
-		for (bool _initial_loop = true;; _initial_loop = false) {
-			if (comp(mid->_data, first->_data)) {
-				if (_initial_loop)
-					newFirst = mid;
-				mid = mid->_next;
-				splice(first, *this, mid->_pre);
-				if (mid == last)
-					return newFirst;
+	link_type _merge_runs(link_type first, link_type second, Compare &comp) {
+		link_type firstTail = first->_pre;
+		link_type secondTail = second->_pre;
+		link_type head;
+		if (comp(second->_data, first->_data)) {
+			head = second;
+			second = second->_next;
+		}
+		else {
+			head = first;
+			first = first->_next;
+		}
+		link_type tail = head;
+		while (first && second) {
+			if (comp(second->_data, first->_data)) {
+				tail->_next = second;
+				second->_pre = tail;
+				tail = second;
+				second = second->_next;
 			}
 			else {
+				tail->_next = first;
+				first->_pre = tail;
+				tail = first;
 				first = first->_next;
-				if (first == mid)
-					return newFirst;
 			}
 		}
-	}
-
-	link_type _advance(link_type p, size_type n) {
-		while (n--)
-			p = p->_next;
-		return p;
+		if (first) {
+			tail->_next = first;
+			first->_pre = tail;
+			tail = firstTail;
+		}
+		else {
+			tail->_next = second;
+			second->_pre = tail;
+			tail = secondTail;
+		}
+		head->_pre = tail;
+		return head;
 	}
 };
 
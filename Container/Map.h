@@ -1,5 +1,6 @@
 #ifndef MAP_H
 #define MAP_H
+#include<tuple>
 #include"RBtree.h"
 
 template<typename Key,typename Value>
@@ -10,25 +11,28 @@ public:
 	}
 };
 
-template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<RBtree_node<T>>>
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<RBtree_node<std::pair<const Key, T>>>>
 class Map {
 public:
-	typedef Key                                                                     key_type;
-	typedef T                                                                       mapped_type;
-	typedef std::pair<const Key, T>                                                 value_type;
-	typedef Compare                                                                 key_compare;
-	typedef Alloc                                                                   allocator_type;
-	typedef value_type&                                                             reference;
-	typedef const value_type&                                                       const_reference;
-	typedef value_type*                                                             pointer;
-	typedef const value_type*                                                       const_pointer;
-	typedef rb_tree_iterator<value_type, value_type&, value_type*>                  iterator;
-	typedef const_rb_tree_iterator<value_type, value_type&, value_type*>            const_iterator;
-	typedef std::reverse_iterator<iterator>                                         reverse_iterator;
-	typedef std::reverse_iterator<const_iterator>                                   const_reverse_iterator;
-	typedef ptrdiff_t                                                               difference_type;
-	typedef size_t                                                                  size_type;
-	typedef RBtree<key_type, value_type, select1st<key_type, mapped_type>, Compare> tree_type;
+	typedef Key                                                                            key_type;
+	typedef T                                                                              mapped_type;
+	typedef std::pair<const Key, T>                                                        value_type;
+	typedef Compare                                                                        key_compare;
+	typedef Alloc                                                                          allocator_type;
+	typedef value_type&                                                                    reference;
+	typedef const value_type&                                                              const_reference;
+	typedef value_type*                                                                    pointer;
+	typedef const value_type*                                                              const_pointer;
+	typedef typename Alloc::value_type                                                     node_type;
+	typedef rb_tree_iterator<value_type, value_type&, value_type*, node_type>              iterator;
+	typedef const_rb_tree_iterator<value_type, value_type&, value_type*, node_type>        const_iterator;
+	typedef std::reverse_iterator<iterator>                                                reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>                                          const_reverse_iterator;
+	typedef ptrdiff_t                                                                      difference_type;
+	typedef size_t                                                                         size_type;
+	typedef RBtree<key_type, value_type, select1st<const Key, T>, Compare, Alloc>          tree_type;
+	typedef typename tree_type::node_handle                                                node_handle;
+	typedef typename tree_type::insert_return_type                                         insert_return_type;
 private:
 	tree_type _tree;
 public:
@@ -97,35 +101,91 @@ public:
 		return -1;
 	}
 
+	static size_type node_overhead() {
+		return tree_type::node_overhead();
+	}
+
+	key_compare key_comp()const {
+		return _tree.key_comp();
+	}
+
+	allocator_type get_allocator()const {
+		return _tree.get_allocator();
+	}
+
 	mapped_type& operator[](const key_type &k) {
-		return (*((_tree.insert_unique(std::make_pair(k, mapped_type()))).first)).second;
+		return try_emplace(k).first->second;
+	}
+
+	mapped_type& operator[](key_type &&k) {
+		return try_emplace(std::move(k)).first->second;
 	}
 
 	mapped_type& at(const key_type &k) {
 		auto it = _tree.find(k);
 		if (it == _tree.end())
 			throw std::exception("");
-		return *it.second;
+		return it->second;
 	}
 
 	std::pair<iterator, bool> insert(const value_type &val) {
 		return _tree.insert_unique(val);
 	}
 
+	iterator insert(const_iterator position, const value_type &val) {
+		return _tree.insert_unique(position, val);
+	}
+
 	template<typename InputIterator>
 	void insert(InputIterator first, InputIterator last) {
-		while (first != last) {
-			_tree.insert_unique(*first);
-			++first;
-		}
+		_tree.insert_unique(first, last);
 	}
 
 	void insert(std::initializer_list<value_type> il) {
-		auto it = il.begin();
-		while (it != il.end()) {
-			_tree.insert_unique(*it);
-			++it;
-		}
+		_tree.insert_unique(il.begin(), il.end());
+	}
+
+	//relinks the handle's node; on a duplicate the node comes back in the result
+	insert_return_type insert(node_handle &&nh) {
+		return _tree.insert_unique(std::move(nh));
+	}
+
+	//on a duplicate nh keeps the node
+	iterator insert(const_iterator position, node_handle &&nh) {
+		insert_return_type res = _tree.insert_unique(std::move(nh));
+		if (!res.inserted)
+			nh = std::move(res.node);
+		return res.position;
+	}
+
+	node_handle extract(const_iterator position) {
+		return _tree.extract(position);
+	}
+
+	//an empty handle when k is absent
+	node_handle extract(const key_type &k) {
+		return _tree.extract(k);
+	}
+
+	//moves the nodes of x whose keys are absent here, the rest stay in x
+	void merge(Map &x) {
+		_tree.merge_unique(x._tree);
+	}
+
+	void merge(Map &&x) {
+		_tree.merge_unique(x._tree);
+	}
+
+	iterator erase(const_iterator position) {
+		return _tree.erase(position);
+	}
+
+	size_type erase(const key_type &k) {
+		return _tree.erase(k);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		return _tree.erase(first, last);
 	}
 
 	void swap(Map &x) {
@@ -136,13 +196,76 @@ public:
 		_tree.clear();
 	}
 
+	void shrink_to_fit() {
+		_tree.shrink_to_fit();
+	}
+
 	template<typename... Args>
 	std::pair<iterator, bool> emplace(Args&&... args) {
-		value_type val(args...);
-		return insert(val);
+		return _tree.emplace_unique(std::forward<Args>(args)...);
 	}
 
-	iterator find(const key_type &k) {
+	template<typename... Args>
+	iterator emplace_hint(const_iterator position, Args&&... args) {
+		return _tree.emplace_hint_unique(position, std::forward<Args>(args)...);
+	}
+
+	//nothing is constructed when k is already present; otherwise the mapped value is built from args inside the new node
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const key_type &k, Args&&... args) {
+		return _tree.emplace_unique_key(k, std::piecewise_construct, std::forward_as_tuple(k), std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	//k is only moved from when a node is created
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(key_type &&k, Args&&... args) {
+		return _tree.emplace_unique_key(k, std::piecewise_construct, std::forward_as_tuple(std::move(k)), std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	template<typename... Args>
+	iterator try_emplace(const_iterator position, const key_type &k, Args&&... args) {
+		return _tree.emplace_hint_unique_key(position, k, std::piecewise_construct, std::forward_as_tuple(k), std::forward_as_tuple(std::forward<Args>(args)...)).first;
+	}
+
+	template<typename... Args>
+	iterator try_emplace(const_iterator position, key_type &&k, Args&&... args) {
+		return _tree.emplace_hint_unique_key(position, k, std::piecewise_construct, std::forward_as_tuple(std::move(k)), std::forward_as_tuple(std::forward<Args>(args)...)).first;
+	}
+
+	//assigns to the existing mapped value instead of replacing the node
+	template<typename M>
+	std::pair<iterator, bool> insert_or_assign(const key_type &k, M &&obj) {
+		auto res = try_emplace(k, std::forward<M>(obj));
+		if (!res.second)
+			res.first->second = std::forward<M>(obj);
+		return res;
+	}
+
+	template<typename M>
+	std::pair<iterator, bool> insert_or_assign(key_type &&k, M &&obj) {
+		auto res = try_emplace(std::move(k), std::forward<M>(obj));
+		if (!res.second)
+			res.first->second = std::forward<M>(obj);
+		return res;
+	}
+
+	template<typename M>
+	iterator insert_or_assign(const_iterator position, const key_type &k, M &&obj) {
+		auto res = _tree.emplace_hint_unique_key(position, k, std::piecewise_construct, std::forward_as_tuple(k), std::forward_as_tuple(std::forward<M>(obj)));
+		if (!res.second)
+			res.first->second = std::forward<M>(obj);
+		return res.first;
+	}
+
+	template<typename M>
+	iterator insert_or_assign(const_iterator position, key_type &&k, M &&obj) {
+		auto res = _tree.emplace_hint_unique_key(position, k, std::piecewise_construct, std::forward_as_tuple(std::move(k)), std::forward_as_tuple(std::forward<M>(obj)));
+		if (!res.second)
+			res.first->second = std::forward<M>(obj);
+		return res.first;
+	}
+
+	iterator find(const key_type &k)const {
 		return _tree.find(k);
 	}
 
@@ -157,6 +280,49 @@ public:
 	iterator upper_bound(const key_type &k)const {
 		return _tree.upper_bound(k);
 	}
+
+	std::pair<iterator, iterator> equal_range(const key_type &k)const {
+		return _tree.equal_range(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &k)const {
+		return _tree.find(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	size_type count(const K &k)const {
+		return _tree.find(k) != end();
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &k)const {
+		return _tree.lower_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &k)const {
+		return _tree.upper_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	std::pair<iterator, iterator> equal_range(const K &k)const {
+		return _tree.equal_range(k);
+	}
+
+	//the order statistics below need Alloc to hand out counted_RBtree_node
+	iterator nth(size_type n)const {
+		return _tree.nth(n);
+	}
+
+	size_type rank(const key_type &k)const {
+		return _tree.rank(k);
+	}
+
+	//elements in [lo, hi)
+	size_type count_range(const key_type &lo, const key_type &hi)const {
+		return _tree.count_range(lo, hi);
+	}
 };
 
 #endif // !MAP_H
\ No newline at end of file
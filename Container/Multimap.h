@@ -0,0 +1,236 @@
+#ifndef MULTIMAP_H
+#define MULTIMAP_H
+#include"Map.h"
+
+//Map that keeps every entry inserted under the same key, in insertion order among themselves, each in its own node,
+//so a key with many values needs no per-key container.
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<RBtree_node<std::pair<const Key, T>>>>
+class Multimap {
+public:
+	typedef Key                                                                            key_type;
+	typedef T                                                                              mapped_type;
+	typedef std::pair<const Key, T>                                                        value_type;
+	typedef Compare                                                                        key_compare;
+	typedef Alloc                                                                          allocator_type;
+	typedef value_type&                                                                    reference;
+	typedef const value_type&                                                              const_reference;
+	typedef value_type*                                                                    pointer;
+	typedef const value_type*                                                              const_pointer;
+	typedef typename Alloc::value_type                                                     node_type;
+	typedef rb_tree_iterator<value_type, value_type&, value_type*, node_type>              iterator;
+	typedef const_rb_tree_iterator<value_type, value_type&, value_type*, node_type>        const_iterator;
+	typedef std::reverse_iterator<iterator>                                                reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>                                          const_reverse_iterator;
+	typedef ptrdiff_t                                                                      difference_type;
+	typedef size_t                                                                         size_type;
+	typedef RBtree<key_type, value_type, select1st<const Key, T>, Compare, Alloc>          tree_type;
+	typedef typename tree_type::node_handle                                                node_handle;
+private:
+	tree_type _tree;
+public:
+	explicit Multimap(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_tree(comp, alloc) {};
+
+	explicit Multimap(const allocator_type &alloc) :_tree(key_compare(), alloc) {};
+
+	template<typename InputIterator>
+	Multimap(InputIterator first, InputIterator last, const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_tree(first, last, comp, true, alloc) {};
+
+	Multimap(const Multimap &x) :_tree(x._tree, true) {};
+
+	Multimap(std::initializer_list<value_type> il, const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_tree(il, comp, true, alloc) {};
+
+	Multimap& operator=(const Multimap &x) {
+		_tree.assign(x._tree, true);
+		return *this;
+	}
+
+	Multimap& operator=(std::initializer_list<value_type> il) {
+		_tree.assign(il, true);
+		return *this;
+	}
+
+	iterator begin()const {
+		return _tree.begin();
+	}
+
+	iterator end()const {
+		return _tree.end();
+	}
+
+	reverse_iterator rbegin()const {
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend()const {
+		return reverse_iterator(begin());
+	}
+
+	const_iterator cbegin()const {
+		return _tree.begin();
+	}
+
+	const_iterator cend()const {
+		return _tree.end();
+	}
+
+	const_reverse_iterator crbegin()const {
+		return const_reverse_iterator(end());
+	}
+
+	const_reverse_iterator crend()const {
+		return const_reverse_iterator(begin());
+	}
+
+	bool empty()const {
+		return _tree.empty();
+	}
+
+	size_type size()const {
+		return _tree.size();
+	}
+
+	size_type max_size()const {
+		return -1;
+	}
+
+	static size_type node_overhead() {
+		return tree_type::node_overhead();
+	}
+
+	//after any entries with the same key
+	iterator insert(const value_type &val) {
+		return _tree.insert_equal(val);
+	}
+
+	iterator insert(const_iterator position, const value_type &val) {
+		return _tree.insert_equal(position, val);
+	}
+
+	template<typename InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		_tree.insert_equal(first, last);
+	}
+
+	void insert(std::initializer_list<value_type> il) {
+		_tree.insert_equal(il.begin(), il.end());
+	}
+
+	iterator insert(node_handle &&nh) {
+		return _tree.insert_equal(std::move(nh));
+	}
+
+	node_handle extract(const_iterator position) {
+		return _tree.extract(position);
+	}
+
+	//the first entry with key k, an empty handle when there is none
+	node_handle extract(const key_type &k) {
+		return _tree.extract(k);
+	}
+
+	//moves every node of x
+	void merge(Multimap &x) {
+		_tree.merge_equal(x._tree);
+	}
+
+	void merge(Multimap &&x) {
+		_tree.merge_equal(x._tree);
+	}
+
+	iterator erase(const_iterator position) {
+		return _tree.erase(position);
+	}
+
+	//every entry with key k, returns how many there were
+	size_type erase(const key_type &k) {
+		return _tree.erase(k);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		return _tree.erase(first, last);
+	}
+
+	void swap(Multimap &x) {
+		_tree.swap(x._tree);
+	}
+
+	void clear() {
+		_tree.clear();
+	}
+
+	void shrink_to_fit() {
+		_tree.shrink_to_fit();
+	}
+
+	template<typename... Args>
+	iterator emplace(Args&&... args) {
+		return _tree.emplace_equal(std::forward<Args>(args)...);
+	}
+
+	template<typename... Args>
+	iterator emplace_hint(const_iterator position, Args&&... args) {
+		return _tree.emplace_hint_equal(position, std::forward<Args>(args)...);
+	}
+
+	//the first entry with key k
+	iterator find(const key_type &k)const {
+		return _tree.find(k);
+	}
+
+	size_type count(const key_type &k)const {
+		return _tree.count_equal(k);
+	}
+
+	iterator lower_bound(const key_type &k)const {
+		return _tree.lower_bound(k);
+	}
+
+	iterator upper_bound(const key_type &k)const {
+		return _tree.upper_bound(k);
+	}
+
+	std::pair<iterator, iterator> equal_range(const key_type &k)const {
+		return _tree.equal_range(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &k)const {
+		return _tree.find(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	size_type count(const K &k)const {
+		return _tree.count_equal(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &k)const {
+		return _tree.lower_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &k)const {
+		return _tree.upper_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	std::pair<iterator, iterator> equal_range(const K &k)const {
+		return _tree.equal_range(k);
+	}
+
+	//the order statistics below, and an O(log n) count, need Alloc to hand out counted_RBtree_node
+	iterator nth(size_type n)const {
+		return _tree.nth(n);
+	}
+
+	size_type rank(const key_type &k)const {
+		return _tree.rank(k);
+	}
+
+	//entries in [lo, hi)
+	size_type count_range(const key_type &lo, const key_type &hi)const {
+		return _tree.count_range(lo, hi);
+	}
+};
+
+#endif // !MULTIMAP_H
\ No newline at end of file
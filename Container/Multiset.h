@@ -0,0 +1,368 @@
+#ifndef MULTISET_H
+#define MULTISET_H
+#include"Set.h"
+#include"Map.h"
+
+//Set that keeps equal elements, each in its own node, in insertion order among themselves.
+template<typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<RBtree_node<T>>>
+class Multiset {
+public:
+	typedef T                                            key_type;
+	typedef T                                            value_type;
+	typedef Compare                                      key_compare;
+	typedef Compare                                      value_compare;
+	typedef Alloc                                        allocator_type;
+	typedef T&                                           reference;
+	typedef const T&                                     const_reference;
+	typedef T*                                           pointer;
+	typedef const T*                                     const_pointer;
+	typedef typename Alloc::value_type                   node_type;
+	typedef const_rb_tree_iterator<T, T&, T*, node_type> iterator;
+	typedef std::reverse_iterator<iterator>              reverse_iterator;
+	typedef ptrdiff_t                                    difference_type;
+	typedef size_t                                       size_type;
+	typedef RBtree<T, T, identity<T>, Compare, Alloc>    tree_type;
+	typedef typename tree_type::node_handle              node_handle;
+private:
+	tree_type _tree;
+public:
+	explicit Multiset(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_tree(comp, alloc) {};
+
+	explicit Multiset(const allocator_type &alloc) :_tree(key_compare(), alloc) {};
+
+	template<typename InputIterator>
+	Multiset(InputIterator first, InputIterator last, const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_tree(first, last, comp, true, alloc) {};
+
+	Multiset(const Multiset &x) :_tree(x._tree, true) {};
+
+	Multiset(std::initializer_list<value_type> il, const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_tree(il, comp, true, alloc) {};
+
+	Multiset& operator=(const Multiset &x) {
+		_tree.assign(x._tree, true);
+		return *this;
+	}
+
+	Multiset& operator=(std::initializer_list<value_type> il) {
+		_tree.assign(il, true);
+		return *this;
+	}
+
+	iterator begin()const {
+		return _tree.begin();
+	}
+
+	iterator end()const {
+		return _tree.end();
+	}
+
+	reverse_iterator rbegin()const {
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend()const {
+		return reverse_iterator(begin());
+	}
+
+	bool empty()const {
+		return _tree.empty();
+	}
+
+	size_type size()const {
+		return _tree.size();
+	}
+
+	size_type max_size()const {
+		return -1;
+	}
+
+	static size_type node_overhead() {
+		return tree_type::node_overhead();
+	}
+
+	//after any elements equal to val
+	iterator insert(const value_type &val) {
+		return _tree.insert_equal(val);
+	}
+
+	iterator insert(iterator position, const value_type &val) {
+		return _tree.insert_equal(position, val);
+	}
+
+	template<typename InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		_tree.insert_equal(first, last);
+	}
+
+	void insert(std::initializer_list<value_type> il) {
+		_tree.insert_equal(il.begin(), il.end());
+	}
+
+	iterator insert(node_handle &&nh) {
+		return _tree.insert_equal(std::move(nh));
+	}
+
+	node_handle extract(iterator position) {
+		return _tree.extract(position);
+	}
+
+	//the first of the elements equal to k, an empty handle when there is none
+	node_handle extract(const key_type &k) {
+		return _tree.extract(k);
+	}
+
+	//moves every node of x
+	void merge(Multiset &x) {
+		_tree.merge_equal(x._tree);
+	}
+
+	void merge(Multiset &&x) {
+		_tree.merge_equal(x._tree);
+	}
+
+	iterator erase(iterator position) {
+		return _tree.erase(position);
+	}
+
+	//every element equal to k, returns how many there were
+	size_type erase(const key_type &k) {
+		return _tree.erase(k);
+	}
+
+	iterator erase(iterator first, iterator last) {
+		return _tree.erase(first, last);
+	}
+
+	void swap(Multiset &x) {
+		_tree.swap(x._tree);
+	}
+
+	void clear() {
+		_tree.clear();
+	}
+
+	void shrink_to_fit() {
+		_tree.shrink_to_fit();
+	}
+
+	template<typename... Args>
+	iterator emplace(Args&&... args) {
+		return _tree.emplace_equal(std::forward<Args>(args)...);
+	}
+
+	template<typename... Args>
+	iterator emplace_hint(iterator position, Args&&... args) {
+		return _tree.emplace_hint_equal(position, std::forward<Args>(args)...);
+	}
+
+	//the first element equal to x
+	iterator find(const value_type &x)const {
+		return _tree.find(x);
+	}
+
+	size_type count(const value_type &x)const {
+		return _tree.count_equal(x);
+	}
+
+	iterator lower_bound(const value_type &x)const {
+		return _tree.lower_bound(x);
+	}
+
+	iterator upper_bound(const value_type &x)const {
+		return _tree.upper_bound(x);
+	}
+
+	std::pair<iterator, iterator> equal_range(const value_type &x)const {
+		return _tree.equal_range(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &x)const {
+		return _tree.find(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	size_type count(const K &x)const {
+		return _tree.count_equal(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &x)const {
+		return _tree.lower_bound(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &x)const {
+		return _tree.upper_bound(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	std::pair<iterator, iterator> equal_range(const K &x)const {
+		return _tree.equal_range(x);
+	}
+
+	//the order statistics below, and an O(log n) count, need Alloc to hand out counted_RBtree_node
+	iterator nth(size_type n)const {
+		return _tree.nth(n);
+	}
+
+	size_type rank(const value_type &x)const {
+		return _tree.rank(x);
+	}
+
+	//elements in [lo, hi)
+	size_type count_range(const value_type &lo, const value_type &hi)const {
+		return _tree.count_range(lo, hi);
+	}
+};
+
+//Multiset for elements whose equal copies are interchangeable: each distinct element has one node holding its
+//multiplicity, so a million duplicates cost one node. Iteration visits the distinct elements as
+//pair<const T, size_t> of element and multiplicity; size() counts every copy.
+template<typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<RBtree_node<std::pair<const T, size_t>>>>
+class CountedMultiset {
+public:
+	typedef T                                           key_type;
+	typedef T                                           value_type;
+	typedef Compare                                     key_compare;
+	typedef Alloc                                       allocator_type;
+	typedef size_t                                      size_type;
+	typedef Map<T, size_type, Compare, Alloc>           count_map;
+	typedef typename count_map::const_iterator          iterator;
+	typedef std::reverse_iterator<iterator>             reverse_iterator;
+private:
+	count_map _counts;
+	size_type _size;
+	Compare _keyCompare;
+public:
+	explicit CountedMultiset(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_counts(comp, alloc), _size(0), _keyCompare(comp) {};
+
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	CountedMultiset(InputIterator first, InputIterator last, const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_counts(comp, alloc), _size(0), _keyCompare(comp) {
+		insert(first, last);
+	};
+
+	CountedMultiset(std::initializer_list<value_type> il, const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) :_counts(comp, alloc), _size(0), _keyCompare(comp) {
+		insert(il.begin(), il.end());
+	};
+
+	iterator begin()const {
+		return _counts.cbegin();
+	}
+
+	iterator end()const {
+		return _counts.cend();
+	}
+
+	reverse_iterator rbegin()const {
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend()const {
+		return reverse_iterator(begin());
+	}
+
+	bool empty()const {
+		return _size == 0;
+	}
+
+	//every copy
+	size_type size()const {
+		return _size;
+	}
+
+	//distinct elements, which is also the number of nodes
+	size_type distinct()const {
+		return _counts.size();
+	}
+
+	//n copies of val
+	iterator insert(const value_type &val, size_type n = 1) {
+		return _add(val, n);
+	}
+
+	//equal neighbours in the input only touch the node found for the first of them
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	void insert(InputIterator first, InputIterator last) {
+		typename count_map::iterator last_added = _counts.end();
+		for (; first != last; ++first) {
+			if (last_added != _counts.end() && !_keyCompare(last_added->first, *first) && !_keyCompare(*first, last_added->first)) {
+				++last_added->second;
+				++_size;
+			}
+			else
+				last_added = _add(*first, 1);
+		}
+	}
+
+	void insert(std::initializer_list<value_type> il) {
+		insert(il.begin(), il.end());
+	}
+
+	//removes at most n copies of k, returns how many were removed
+	size_type erase(const key_type &k, size_type n) {
+		auto it = _counts.find(k);
+		if (it == _counts.end())
+			return 0;
+		if (n < it->second) {
+			it->second -= n;
+			_size -= n;
+			return n;
+		}
+		n = it->second;
+		_counts.erase(it);
+		_size -= n;
+		return n;
+	}
+
+	//every copy of k
+	size_type erase(const key_type &k) {
+		return erase(k, size_type(-1));
+	}
+
+	//every copy of the element at position
+	iterator erase(iterator position) {
+		_size -= position->second;
+		return _counts.erase(position);
+	}
+
+	void swap(CountedMultiset &x) {
+		_counts.swap(x._counts);
+		std::swap(_size, x._size);
+	}
+
+	void clear() {
+		_counts.clear();
+		_size = 0;
+	}
+
+	void shrink_to_fit() {
+		_counts.shrink_to_fit();
+	}
+
+	iterator find(const key_type &k)const {
+		return _counts.find(k);
+	}
+
+	//one descent, however many copies there are
+	size_type count(const key_type &k)const {
+		iterator it = _counts.find(k);
+		return it == end() ? 0 : it->second;
+	}
+
+	iterator lower_bound(const key_type &k)const {
+		return _counts.lower_bound(k);
+	}
+
+	iterator upper_bound(const key_type &k)const {
+		return _counts.upper_bound(k);
+	}
+private:
+	typename count_map::iterator _add(const value_type &val, size_type n) {
+		typename count_map::iterator it = _counts.try_emplace(val, 0).first;
+		it->second += n;
+		_size += n;
+		return it;
+	}
+};
+
+#endif // !MULTISET_H
\ No newline at end of file
@@ -0,0 +1,413 @@
+#ifndef PERSISTENTMAP_H
+#define PERSISTENTMAP_H
+#include<memory>
+#include<atomic>
+#include<thread>
+#include<algorithm>
+#include<functional>
+#include<iterator>
+#include<initializer_list>
+#include<utility>
+
+//Never changes after it is linked into a version. Every version and every parent holds one reference.
+template<typename Value>
+class persistent_node {
+public:
+	typedef persistent_node* link_type;
+
+	Value _value;
+	link_type _left;
+	link_type _right;
+	std::atomic<size_t> _refs;
+	unsigned char _height;
+
+	persistent_node(const Value &val, link_type left, link_type right, unsigned char height) \
+		:_value(val), _left(left), _right(right), _refs(1), _height(height) {};
+};
+
+//in-order walk over one version, the stack holds the current node and the ancestors still to be visited
+template<typename Value>
+class persistent_iterator {
+public:
+	typedef Value                       value_type;
+	typedef const Value&                reference;
+	typedef const Value*                pointer;
+	typedef ptrdiff_t                   difference_type;
+	typedef std::forward_iterator_tag   iterator_category;
+	typedef persistent_node<Value>*     link_type;
+	//an AVL tree of height 64 holds more than 2^44 nodes
+	static const int max_depth = 64;
+private:
+	link_type _stack[max_depth];
+	int _depth;
+public:
+	persistent_iterator() :_depth(0) {};
+
+	persistent_iterator(const persistent_iterator &x) :_depth(x._depth) {
+		for (int i = 0; i < _depth; ++i)
+			_stack[i] = x._stack[i];
+	};
+
+	persistent_iterator& operator=(const persistent_iterator &x) {
+		_depth = x._depth;
+		for (int i = 0; i < _depth; ++i)
+			_stack[i] = x._stack[i];
+		return *this;
+	}
+
+	bool operator==(const persistent_iterator &x)const {
+		if (_depth == 0 || x._depth == 0)
+			return _depth == x._depth;
+		return _stack[_depth - 1] == x._stack[x._depth - 1];
+	}
+
+	bool operator!=(const persistent_iterator &x)const {
+		return !(*this == x);
+	}
+
+	reference operator*()const {
+		return _stack[_depth - 1]->_value;
+	}
+
+	pointer operator->()const {
+		return &(_stack[_depth - 1]->_value);
+	}
+
+	persistent_iterator& operator++() {
+		link_type h = _stack[--_depth]->_right;
+		_push_left(h);
+		return *this;
+	}
+
+	persistent_iterator operator++(int) {
+		persistent_iterator ret(*this);
+		++*this;
+		return ret;
+	}
+
+	void _push_left(link_type h) {
+		while (h) {
+			_stack[_depth++] = h;
+			h = h->_left;
+		}
+	}
+
+	void _push(link_type h) {
+		_stack[_depth++] = h;
+	}
+};
+
+//Map whose versions share structure. Copying a PersistentMap (or calling snapshot()) is O(1) and yields an immutable
+//version; insert, insert_or_assign and erase copy only the O(log n) nodes on the search path and leave every other
+//version untouched. Balanced by height (AVL), which keeps path-copying deletion simple.
+//Threading: one writer at a time may modify a PersistentMap while any number of readers call snapshot() on it;
+//readers then search and iterate their snapshot without locks. Nodes are freed by whichever side drops the last reference.
+template<typename Key, typename T, typename Compare = std::less<Key>>
+class PersistentMap {
+public:
+	typedef Key                                      key_type;
+	typedef T                                        mapped_type;
+	typedef std::pair<const Key, T>                  value_type;
+	typedef Compare                                  key_compare;
+	typedef const value_type&                        const_reference;
+	typedef persistent_node<value_type>              node_type;
+	typedef node_type*                               link_type;
+	typedef persistent_iterator<value_type>          iterator;
+	typedef iterator                                 const_iterator;
+	typedef ptrdiff_t                                difference_type;
+	typedef size_t                                   size_type;
+private:
+	link_type _root;
+	size_type _size;
+	//guards _root and _size only while a version is published or copied, never during a search
+	mutable std::atomic<bool> _busy;
+	Compare _keyCompare;
+	std::allocator<node_type> _alloc;
+public:
+	explicit PersistentMap(const key_compare &comp = key_compare()) :_root(nullptr), _size(0), _busy(false), _keyCompare(comp) {};
+
+	PersistentMap(std::initializer_list<value_type> il, const key_compare &comp = key_compare()) :_root(nullptr), _size(0), _busy(false), _keyCompare(comp) {
+		for (auto it = il.begin(); it != il.end(); ++it)
+			insert(*it);
+	};
+
+	template<typename InputIterator>
+	PersistentMap(InputIterator first, InputIterator last, const key_compare &comp = key_compare()) :_root(nullptr), _size(0), _busy(false), _keyCompare(comp) {
+		for (; first != last; ++first)
+			insert(*first);
+	};
+
+	PersistentMap(const PersistentMap &x) :_busy(false), _keyCompare(x._keyCompare) {
+		x._lock();
+		_root = _acquire(x._root);
+		_size = x._size;
+		x._unlock();
+	};
+
+	PersistentMap& operator=(const PersistentMap &x) {
+		if (this == &x)
+			return *this;
+		x._lock();
+		link_type root = _acquire(x._root);
+		size_type size = x._size;
+		x._unlock();
+		_publish(root, size);
+		return *this;
+	}
+
+	~PersistentMap() {
+		_release(_root);
+	}
+
+	//the current version, which later changes to *this do not affect
+	PersistentMap snapshot()const {
+		return *this;
+	}
+
+	iterator begin()const {
+		iterator it;
+		it._push_left(_root);
+		return it;
+	}
+
+	iterator end()const {
+		return iterator();
+	}
+
+	bool empty()const {
+		return _size == 0;
+	}
+
+	size_type size()const {
+		return _size;
+	}
+
+	//returns false and changes nothing when the key is already present
+	bool insert(const value_type &val) {
+		bool changed = false;
+		link_type root = _insert(_root, val, false, changed);
+		if (!changed)
+			return false;
+		_publish(root, _size + 1);
+		return true;
+	}
+
+	//true if the key was new
+	bool insert_or_assign(const key_type &k, const mapped_type &obj) {
+		bool inserted = !_exists_in(_root, k);
+		bool changed = false;
+		link_type root = _insert(_root, value_type(k, obj), true, changed);
+		_publish(root, inserted ? _size + 1 : _size);
+		return inserted;
+	}
+
+	size_type erase(const key_type &k) {
+		bool changed = false;
+		link_type root = _erase(_root, k, changed);
+		if (!changed)
+			return 0;
+		_publish(root, _size - 1);
+		return 1;
+	}
+
+	void clear() {
+		_publish(nullptr, 0);
+	}
+
+	void swap(PersistentMap &x) {
+		PersistentMap tmp(x);
+		x = *this;
+		*this = tmp;
+	}
+
+	const mapped_type& at(const key_type &k)const {
+		iterator it = find(k);
+		if (it == end())
+			throw std::exception("");
+		return it->second;
+	}
+
+	iterator find(const key_type &k)const {
+		iterator it = lower_bound(k);
+		if (it == end() || _keyCompare(k, it->first))
+			return end();
+		return it;
+	}
+
+	size_type count(const key_type &k)const {
+		return _exists_in(_root, k);
+	}
+
+	iterator lower_bound(const key_type &k)const {
+		iterator it;
+		link_type h = _root;
+		while (h) {
+			if (_keyCompare(h->_value.first, k))
+				h = h->_right;
+			else {
+				it._push(h);
+				h = h->_left;
+			}
+		}
+		return it;
+	}
+
+	iterator upper_bound(const key_type &k)const {
+		iterator it;
+		link_type h = _root;
+		while (h) {
+			if (_keyCompare(k, h->_value.first)) {
+				it._push(h);
+				h = h->_left;
+			}
+			else
+				h = h->_right;
+		}
+		return it;
+	}
+private:
+	//the critical section is a pointer swap, so a short spin usually wins; past that the holder was likely descheduled
+	void _lock()const {
+		for (int spins = 0; _busy.exchange(true, std::memory_order_acquire); ++spins)
+			if (spins >= 16)
+				std::this_thread::yield();
+	}
+
+	void _unlock()const {
+		_busy.store(false, std::memory_order_release);
+	}
+
+	//swaps in a new version; the old one is released outside the lock, since that may free a whole path
+	void _publish(link_type root, size_type size) {
+		_lock();
+		link_type old = _root;
+		_root = root;
+		_size = size;
+		_unlock();
+		_release(old);
+	}
+
+	static link_type _acquire(link_type h) {
+		if (h)
+			h->_refs.fetch_add(1, std::memory_order_relaxed);
+		return h;
+	}
+
+	//only nodes that drop to zero are visited, so this recurses along freed paths only
+	void _release(link_type h) {
+		if (!h || h->_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+		_release(h->_left);
+		_release(h->_right);
+		_alloc.destroy(h);
+		_alloc.deallocate(h, 1);
+	}
+
+	static int _height(link_type h) {
+		return h ? h->_height : 0;
+	}
+
+	//takes over the references held by left and right
+	link_type _make(const value_type &val, link_type left, link_type right) {
+		link_type node = _alloc.allocate(1);
+		int height = std::max(_height(left), _height(right)) + 1;
+		_alloc.construct(node, val, left, right, (unsigned char)height);
+		return node;
+	}
+
+	//Like _make, but restores the AVL balance when one side is two levels deeper; left and right differ by at most two
+	//after a single insert or erase below. Releasing the rotated child frees it if this update created it.
+	link_type _balance(const value_type &val, link_type left, link_type right) {
+		int hl = _height(left);
+		int hr = _height(right);
+		if (hl > hr + 1) {
+			link_type res;
+			if (_height(left->_left) >= _height(left->_right))
+				res = _make(left->_value, _acquire(left->_left), _make(val, _acquire(left->_right), right));
+			else {
+				link_type lr = left->_right;
+				res = _make(lr->_value, _make(left->_value, _acquire(left->_left), _acquire(lr->_left)), _make(val, _acquire(lr->_right), right));
+			}
+			_release(left);
+			return res;
+		}
+		if (hr > hl + 1) {
+			link_type res;
+			if (_height(right->_right) >= _height(right->_left))
+				res = _make(right->_value, _make(val, left, _acquire(right->_left)), _acquire(right->_right));
+			else {
+				link_type rl = right->_left;
+				res = _make(rl->_value, _make(val, left, _acquire(rl->_left)), _make(right->_value, _acquire(rl->_right), _acquire(right->_right)));
+			}
+			_release(right);
+			return res;
+		}
+		return _make(val, left, right);
+	}
+
+	bool _exists_in(link_type h, const key_type &k)const {
+		while (h) {
+			if (_keyCompare(k, h->_value.first))
+				h = h->_left;
+			else if (_keyCompare(h->_value.first, k))
+				h = h->_right;
+			else
+				return true;
+		}
+		return false;
+	}
+
+	//Returns the new root of the subtree with one reference owned by the caller, or sets changed to false and returns
+	//nullptr when the key exists and assign is false.
+	link_type _insert(link_type h, const value_type &val, bool assign, bool &changed) {
+		if (!h) {
+			changed = true;
+			return _make(val, nullptr, nullptr);
+		}
+		if (_keyCompare(val.first, h->_value.first)) {
+			link_type left = _insert(h->_left, val, assign, changed);
+			return changed ? _balance(h->_value, left, _acquire(h->_right)) : nullptr;
+		}
+		if (_keyCompare(h->_value.first, val.first)) {
+			link_type right = _insert(h->_right, val, assign, changed);
+			return changed ? _balance(h->_value, _acquire(h->_left), right) : nullptr;
+		}
+		if (!assign)
+			return nullptr;
+		changed = true;
+		return _make(val, _acquire(h->_left), _acquire(h->_right));
+	}
+
+	//same contract as _insert; changed stays false when k is absent
+	link_type _erase(link_type h, const key_type &k, bool &changed) {
+		if (!h)
+			return nullptr;
+		if (_keyCompare(k, h->_value.first)) {
+			link_type left = _erase(h->_left, k, changed);
+			return changed ? _balance(h->_value, left, _acquire(h->_right)) : nullptr;
+		}
+		if (_keyCompare(h->_value.first, k)) {
+			link_type right = _erase(h->_right, k, changed);
+			return changed ? _balance(h->_value, _acquire(h->_left), right) : nullptr;
+		}
+		changed = true;
+		if (!h->_left)
+			return _acquire(h->_right);
+		if (!h->_right)
+			return _acquire(h->_left);
+		//the successor takes h's place; its node stays alive through the old version until this one is published
+		link_type successor = h->_right;
+		while (successor->_left)
+			successor = successor->_left;
+		link_type right = _erase_min(h->_right);
+		return _balance(successor->_value, _acquire(h->_left), right);
+	}
+
+	link_type _erase_min(link_type h) {
+		if (!h->_left)
+			return _acquire(h->_right);
+		return _balance(h->_value, _erase_min(h->_left), _acquire(h->_right));
+	}
+};
+
+#endif // !PERSISTENTMAP_H
\ No newline at end of file
@@ -0,0 +1,167 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+#include<memory>
+#include<type_traits>
+#include<utility>
+
+//Free nodes are threaded through the node's own _next, so a chain that is already linked that way can be returned in O(1).
+template<typename Node>
+class pool_link {
+public:
+	Node*& operator()(Node *p)const {
+		return p->_next;
+	}
+};
+
+template<typename Node, size_t ChunkNodes = 256, typename Link = pool_link<Node>>
+class node_pool {
+public:
+	typedef Node   value_type;
+	typedef Node*  pointer;
+	typedef size_t size_type;
+	static_assert(ChunkNodes >= 2, "node_pool needs at least two nodes per chunk, the first one links the chunks");
+private:
+	pointer _freeList;
+	pointer _chunks;
+	pointer _bumpCur;
+	pointer _bumpEnd;
+	//hand out fresh chunk slots before recycled nodes, so nodes allocated together sit together
+	bool _insertionOrder;
+	Link _link;
+	std::allocator<Node> _alloc;
+public:
+	explicit node_pool(bool insertionOrder = false) :_freeList(nullptr), _chunks(nullptr), _bumpCur(nullptr), _bumpEnd(nullptr), _insertionOrder(insertionOrder) {};
+
+	node_pool(const node_pool&) = delete;
+
+	node_pool& operator=(const node_pool&) = delete;
+
+	~node_pool() {
+		release();
+	}
+
+	pointer allocate() {
+		if (_insertionOrder && _bumpCur != _bumpEnd)
+			return _bumpCur++;
+		if (_freeList) {
+			pointer p = _freeList;
+			_freeList = _link(p);
+			return p;
+		}
+		if (_bumpCur == _bumpEnd)
+			_new_chunk();
+		return _bumpCur++;
+	}
+
+	void deallocate(pointer p) {
+		_link(p) = _freeList;
+		_freeList = p;
+	}
+
+	//[first, last] must already be linked through Link
+	void deallocate_chain(pointer first, pointer last) {
+		_link(last) = _freeList;
+		_freeList = first;
+	}
+
+	//frees every chunk at once, nodes still in use become dangling
+	void release() {
+		while (_chunks) {
+			pointer chunk = _chunks;
+			_chunks = _link(chunk);
+			_alloc.deallocate(chunk, ChunkNodes);
+		}
+		_freeList = _bumpCur = _bumpEnd = nullptr;
+	}
+private:
+	void _new_chunk() {
+		//the first node of every chunk only links the chunks together
+		pointer chunk = _alloc.allocate(ChunkNodes);
+		_link(chunk) = _chunks;
+		_chunks = chunk;
+		_bumpCur = chunk + 1;
+		_bumpEnd = chunk + ChunkNodes;
+	}
+};
+
+//Copies share one node_pool, so several containers can draw from the same chunks. Not thread-safe.
+template<typename Node, size_t ChunkNodes = 256, typename Link = pool_link<Node>>
+class Pool_allocator {
+public:
+	typedef Node                                value_type;
+	typedef Node*                               pointer;
+	typedef const Node*                         const_pointer;
+	typedef Node&                               reference;
+	typedef const Node&                         const_reference;
+	typedef size_t                              size_type;
+	typedef ptrdiff_t                           difference_type;
+	typedef node_pool<Node, ChunkNodes, Link>   pool_type;
+private:
+	std::shared_ptr<pool_type> _pool;
+public:
+	explicit Pool_allocator(bool insertionOrder = false) :_pool(std::make_shared<pool_type>(insertionOrder)) {};
+
+	Pool_allocator(const Pool_allocator &x) :_pool(x._pool) {};
+
+	Pool_allocator& operator=(const Pool_allocator &x) {
+		_pool = x._pool;
+		return *this;
+	}
+
+	pointer allocate(size_type n) {
+		if (n == 1)
+			return _pool->allocate();
+		return std::allocator<Node>().allocate(n);
+	}
+
+	void deallocate(pointer p, size_type n) {
+		if (n == 1)
+			_pool->deallocate(p);
+		else
+			std::allocator<Node>().deallocate(p, n);
+	}
+
+	void deallocate_chain(pointer first, pointer last) {
+		_pool->deallocate_chain(first, last);
+	}
+
+	//drops all chunks when this is the only allocator drawing from the pool, for containers that can forget their nodes
+	bool release() {
+		if (_pool.use_count() != 1)
+			return false;
+		_pool->release();
+		return true;
+	}
+
+	template<typename U, typename... Args>
+	void construct(U *p, Args&&... args) {
+		::new((void*)p) U(std::forward<Args>(args)...);
+	}
+
+	template<typename U>
+	void destroy(U *p) {
+		p->~U();
+	}
+
+	bool operator==(const Pool_allocator &x)const {
+		return _pool == x._pool;
+	}
+
+	bool operator!=(const Pool_allocator &x)const {
+		return _pool != x._pool;
+	}
+};
+
+template<typename Alloc, typename = void>
+struct has_deallocate_chain :public std::false_type {};
+
+template<typename Alloc>
+struct has_deallocate_chain<Alloc, decltype(std::declval<Alloc&>().deallocate_chain(std::declval<typename Alloc::pointer>(), std::declval<typename Alloc::pointer>()), void())> :public std::true_type {};
+
+template<typename Alloc, typename = void>
+struct has_release :public std::false_type {};
+
+template<typename Alloc>
+struct has_release<Alloc, decltype(std::declval<Alloc&>().release(), void())> :public std::true_type {};
+
+#endif // !POOL_ALLOCATOR_H
\ No newline at end of file
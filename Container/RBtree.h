@@ -2,9 +2,17 @@
 #define RBTREE_H
 #include<memory>
 #include<initializer_list>
+#include<utility>
+#include<iterator>
+#include<cstdint>
+#include<type_traits>
+#include"Pool_allocator.h"
 #define RED true
 #define BLACK false
 
+//selects the node constructors that build the value in place from the remaining arguments
+struct in_place_node_t {};
+
 template<typename Value>
 class RBtree_node {
 public:
@@ -19,9 +27,144 @@ public:
 
 	RBtree_node(const Value &val, link_type parent = nullptr, link_type left = nullptr, link_type right = nullptr, color_type color = RED) \
 		:_value(val), _parent(parent), _left(left), _right(right), _color(color) {};
+
+	template<typename... Args>
+	RBtree_node(in_place_node_t, Args&&... args) :_value(std::forward<Args>(args)...), _parent(nullptr), _left(nullptr), _right(nullptr), _color(RED) {};
+
+	link_type parent()const {
+		return _parent;
+	}
+
+	void set_parent(link_type parent) {
+		_parent = parent;
+	}
+
+	color_type color()const {
+		return _color;
+	}
+
+	void set_color(color_type color) {
+		_color = color;
+	}
+};
+
+//Same interface as RBtree_node, but the color sits in the low bit of the parent pointer, which node alignment leaves free.
+//Pass std::allocator<compact_RBtree_node<Value>> (or another allocator of it) as Alloc to use it.
+template<typename Value>
+class compact_RBtree_node {
+public:
+	typedef bool                 color_type;
+	typedef compact_RBtree_node* link_type;
+
+	Value _value;
+	uintptr_t _parentColor;
+	link_type _left;
+	link_type _right;
+
+	compact_RBtree_node(const Value &val, link_type parent = nullptr, link_type left = nullptr, link_type right = nullptr, color_type color = RED) \
+		:_value(val), _parentColor(reinterpret_cast<uintptr_t>(parent) | (color == RED ? 1 : 0)), _left(left), _right(right) {};
+
+	template<typename... Args>
+	compact_RBtree_node(in_place_node_t, Args&&... args) :_value(std::forward<Args>(args)...), _parentColor(1), _left(nullptr), _right(nullptr) {};
+
+	link_type parent()const {
+		return reinterpret_cast<link_type>(_parentColor & ~uintptr_t(1));
+	}
+
+	void set_parent(link_type parent) {
+		_parentColor = reinterpret_cast<uintptr_t>(parent) | (_parentColor & 1);
+	}
+
+	color_type color()const {
+		return (_parentColor & 1) ? RED : BLACK;
+	}
+
+	void set_color(color_type color) {
+		_parentColor = (_parentColor & ~uintptr_t(1)) | (color == RED ? 1 : 0);
+	}
+};
+
+//RBtree_node plus the size of the subtree rooted here, which lets the tree answer nth, rank and count_range in O(log n).
+//Pass std::allocator<counted_RBtree_node<Value>> as Alloc to use it.
+template<typename Value>
+class counted_RBtree_node {
+public:
+	typedef bool                 color_type;
+	typedef counted_RBtree_node* link_type;
+
+	Value _value;
+	color_type _color;
+	link_type _parent;
+	link_type _left;
+	link_type _right;
+	size_t _count;
+
+	counted_RBtree_node(const Value &val, link_type parent = nullptr, link_type left = nullptr, link_type right = nullptr, color_type color = RED) \
+		:_value(val), _parent(parent), _left(left), _right(right), _color(color), _count(1) {};
+
+	template<typename... Args>
+	counted_RBtree_node(in_place_node_t, Args&&... args) :_value(std::forward<Args>(args)...), _parent(nullptr), _left(nullptr), _right(nullptr), _color(RED), _count(1) {};
+
+	void augment() {
+		_count = (_left ? _left->_count : 0) + (_right ? _right->_count : 0) + 1;
+	}
+
+	link_type parent()const {
+		return _parent;
+	}
+
+	void set_parent(link_type parent) {
+		_parent = parent;
+	}
+
+	color_type color()const {
+		return _color;
+	}
+
+	void set_color(color_type color) {
+		_color = color;
+	}
 };
 
-template<typename Value,typename Ref,typename Ptr>
+//A node with augment() summarizes its subtree; RBtree calls it bottom-up whenever the children below a node change.
+template<typename Node, typename = void>
+struct is_augmented_node :public std::false_type {};
+
+template<typename Node>
+struct is_augmented_node<Node, decltype(std::declval<Node&>().augment(), void())> :public std::true_type {};
+
+template<typename Node, typename = void>
+struct has_subtree_count :public std::false_type {};
+
+template<typename Node>
+struct has_subtree_count<Node, decltype(std::declval<Node&>()._count, void())> :public std::true_type {};
+
+//free pool nodes are threaded through _right
+template<typename Value>
+class pool_link<RBtree_node<Value>> {
+public:
+	RBtree_node<Value>*& operator()(RBtree_node<Value> *p)const {
+		return p->_right;
+	}
+};
+
+template<typename Value>
+class pool_link<compact_RBtree_node<Value>> {
+public:
+	compact_RBtree_node<Value>*& operator()(compact_RBtree_node<Value> *p)const {
+		return p->_right;
+	}
+};
+
+template<typename Value>
+class pool_link<counted_RBtree_node<Value>> {
+public:
+	counted_RBtree_node<Value>*& operator()(counted_RBtree_node<Value> *p)const {
+		return p->_right;
+	}
+};
+
+template<typename Value, typename Ref, typename Ptr, typename Node = RBtree_node<Value>>
 class rb_tree_iterator {
 public:
 	typedef Value                           value_type;
@@ -29,7 +172,7 @@ public:
 	typedef Ptr                             pointer;
 	typedef ptrdiff_t                       difference_type;
 	typedef std::bidirectional_iterator_tag iterator_category;
-	typedef RBtree_node<Value>*             link_type;
+	typedef Node*                           link_type;
 protected:
 	link_type _ptr;
 public:
@@ -67,10 +210,10 @@ public:
 				_ptr = _ptr->_left;
 		}
 		else {
-			link_type p = _ptr->_parent;
+			link_type p = _ptr->parent();
 			while (p->_right == _ptr) {
 				_ptr = p;
-				p = p->_parent;
+				p = p->parent();
 			}
 			if (_ptr->_right != p)
 				_ptr = p;
@@ -85,7 +228,7 @@ public:
 	}
 
 	rb_tree_iterator& operator--() {
-		if (_ptr->_color == RED && _ptr->_parent->_parent == _ptr)
+		if (_ptr->color() == RED && _ptr->parent()->parent() == _ptr)
 			_ptr = _ptr->_right;
 		else if (_ptr->_left) {
 			_ptr = _ptr->_left;
@@ -93,10 +236,10 @@ public:
 				_ptr = _ptr->_right;
 		}
 		else {
-			link_type p = _ptr->_parent;
+			link_type p = _ptr->parent();
 			while (p->_left == _ptr) {
 				_ptr = p;
-				p = p->_parent;
+				p = p->parent();
 			}
 			_ptr = p;
 		}
@@ -114,16 +257,16 @@ public:
 	}
 };
 
-template<typename Value, typename Ref, typename Ptr>
-class const_rb_tree_iterator :public rb_tree_iterator<Value, Ref, Ptr> {
+template<typename Value, typename Ref, typename Ptr, typename Node = RBtree_node<Value>>
+class const_rb_tree_iterator :public rb_tree_iterator<Value, Ref, Ptr, Node> {
 public:
-	typedef Value                             value_type;
-	typedef Ref                               reference;
-	typedef Ptr                               pointer;
-	typedef ptrdiff_t                         difference_type;
-	typedef std::bidirectional_iterator_tag   iterator_category;
-	typedef RBtree_node<Value>*               link_type;
-	typedef rb_tree_iterator<Value, Ref, Ptr> parent_iterator;
+	typedef Value                                   value_type;
+	typedef Ref                                     reference;
+	typedef Ptr                                     pointer;
+	typedef ptrdiff_t                               difference_type;
+	typedef std::bidirectional_iterator_tag         iterator_category;
+	typedef Node*                                   link_type;
+	typedef rb_tree_iterator<Value, Ref, Ptr, Node> parent_iterator;
 
 	const_rb_tree_iterator(const parent_iterator &x) :parent_iterator(x) {};
 
@@ -163,20 +306,120 @@ public:
 	}
 };
 
+//Owns a node taken out of a tree, value intact, until a tree with an equal allocator links it again; otherwise the
+//node is destroyed with the handle. key() and mapped() only exist for pair values.
+template<typename Value, typename Alloc>
+class rb_tree_node_handle {
+public:
+	typedef Value                          value_type;
+	typedef Alloc                          allocator_type;
+	typedef typename Alloc::value_type*    link_type;
+
+	link_type _node;
+	allocator_type _alloc;
+
+	rb_tree_node_handle() :_node(nullptr), _alloc() {};
+
+	rb_tree_node_handle(link_type node, const allocator_type &alloc) :_node(node), _alloc(alloc) {};
+
+	rb_tree_node_handle(rb_tree_node_handle &&x) :_node(x._node), _alloc(x._alloc) {
+		x._node = nullptr;
+	};
+
+	rb_tree_node_handle(const rb_tree_node_handle&) = delete;
+
+	rb_tree_node_handle& operator=(rb_tree_node_handle &&x) {
+		if (this == &x)
+			return *this;
+		_destroy();
+		_node = x._node;
+		_alloc = x._alloc;
+		x._node = nullptr;
+		return *this;
+	}
+
+	rb_tree_node_handle& operator=(const rb_tree_node_handle&) = delete;
+
+	~rb_tree_node_handle() {
+		_destroy();
+	}
+
+	bool empty()const {
+		return !_node;
+	}
+
+	explicit operator bool()const {
+		return _node != nullptr;
+	}
+
+	allocator_type get_allocator()const {
+		return _alloc;
+	}
+
+	value_type& value()const {
+		return _node->_value;
+	}
+
+	//the key may be changed before the node is inserted again
+	template<typename V = Value>
+	typename std::remove_const<typename V::first_type>::type& key()const {
+		return const_cast<typename std::remove_const<typename V::first_type>::type&>(_node->_value.first);
+	}
+
+	template<typename V = Value>
+	typename V::second_type& mapped()const {
+		return _node->_value.second;
+	}
+
+	void swap(rb_tree_node_handle &x) {
+		std::swap(_node, x._node);
+		std::swap(_alloc, x._alloc);
+	}
+
+	//gives up ownership without destroying the node
+	link_type _release() {
+		link_type node = _node;
+		_node = nullptr;
+		return node;
+	}
+
+	void _destroy() {
+		if (!_node)
+			return;
+		_alloc.destroy(_node);
+		_alloc.deallocate(_node, 1);
+		_node = nullptr;
+	}
+};
+
+//node keeps the handle when it was not inserted
+template<typename Iterator, typename NodeHandle>
+struct rb_tree_insert_return {
+	Iterator position;
+	bool inserted;
+	NodeHandle node;
+};
+
 template<typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc = std::allocator<RBtree_node<Value>>>
 class RBtree {
 public:
-	typedef Key                                     key_type;
-	typedef Value                                   value_type;
-	typedef size_t                                  size_type;
-	typedef RBtree_node<Value>*                     link_type;
-	typedef Alloc                                   allocator_type;
-	typedef Value&                                  reference;
-	typedef Value*                                  pointer;
-	typedef rb_tree_iterator<Value, Value&, Value*> iterator;
+	typedef Key                                                key_type;
+	typedef Value                                              value_type;
+	typedef size_t                                             size_type;
+	typedef typename Alloc::value_type                         node_type;
+	typedef node_type*                                         link_type;
+	typedef typename node_type::color_type                     color_type;
+	typedef Alloc                                              allocator_type;
+	typedef Value&                                             reference;
+	typedef Value*                                             pointer;
+	typedef rb_tree_iterator<Value, Value&, Value*, node_type> iterator;
+	typedef rb_tree_node_handle<Value, Alloc>                  node_handle;
+	typedef rb_tree_insert_return<iterator, node_handle>       insert_return_type;
 private:
 	link_type _header;
 	size_type _size;
+	//erased nodes, chained through _right and reused by later inserts
+	link_type _freeList;
 	Compare _keyCompare;
 	KeyOfValue _keyOfValue;
 	allocator_type _alloc;
@@ -188,78 +431,227 @@ public:
 	template<typename InputIterator>
 	RBtree(InputIterator first, InputIterator last, const Compare &compare, bool repeat, const allocator_type &alloc = allocator_type()) :_keyCompare(compare), _alloc(alloc), _keyOfValue() {
 		_init_header();
-		if (repeat) {
-			while (first != last) {
-				insert_equal(*first);
-				++first;
-			}
-		}
-		else {
-			while (first != last) {
-				insert_unique(*first);
-				++first;
-			}
-		}
+		if (repeat)
+			insert_equal(first, last);
+		else
+			insert_unique(first, last);
 	};
 
+	//x already holds keys that fit repeat, so its shape is cloned as is
 	RBtree(const RBtree &x, bool repeat) :_keyCompare(x._keyCompare), _alloc(x._alloc), _keyOfValue() {
 		_init_header();
-		if (repeat) {
-			for (auto it = x.begin(); it != x.end(); ++it)
-				insert_equal(*it);
-		}
-		else {
-			for (auto it = x.begin(); it != x.end(); ++it)
-				insert_unique(*it);
-		}
+		_copy_from(x);
 	};
 
 	RBtree(std::initializer_list<value_type> il, const Compare &compare, bool repeat, const allocator_type &alloc = allocator_type()) :_keyCompare(compare), _alloc(alloc), _keyOfValue() {
 		_init_header();
-		if (repeat) {
-			for (auto it = il.begin(); it != il.end(); ++it)
-				insert_equal(*it);
-		}
-		else {
-			for (auto it = il.begin(); it != il.end(); ++it)
-				insert_unique(*it);
-		}
+		if (repeat)
+			insert_equal(il.begin(), il.end());
+		else
+			insert_unique(il.begin(), il.end());
 	};
 
 	~RBtree() {
+		if (_release_all())
+			return;
 		clear();
 		_alloc.deallocate(_header, 1);
 	}
 
 	std::pair<iterator, bool> insert_unique(const value_type &x) {
-		if (_size == 0) {
-			_header->_left = _header->_right = _header->_parent = _alloc.allocate(1);
-			_alloc.construct(_header->_parent, x, _header, nullptr, nullptr, BLACK);
-			++_size;
-			return std::pair<iterator, bool>(_header->_parent, true);
+		link_type parent;
+		bool insertLeft;
+		if (!_unique_pos(_keyOfValue(x), parent, insertLeft))
+			return std::pair<iterator, bool>(parent, false);
+		return std::pair<iterator, bool>(_insert_node(parent, insertLeft, x), true);
+	}
+
+	//Descends on k alone; a node is only created when k is absent, with its value built in place from args.
+	template<typename K, typename... Args>
+	std::pair<iterator, bool> emplace_unique_key(const K &k, Args&&... args) {
+		link_type parent;
+		bool insertLeft;
+		if (!_unique_pos(k, parent, insertLeft))
+			return std::pair<iterator, bool>(parent, false);
+		return std::pair<iterator, bool>(_insert_node(parent, insertLeft, std::forward<Args>(args)...), true);
+	}
+
+	//The key is only known once the value exists, so the value is built inside a fresh node first;
+	//on a duplicate that node goes straight to the free list.
+	template<typename... Args>
+	std::pair<iterator, bool> emplace_unique(Args&&... args) {
+		link_type node = _get_node();
+		_alloc.construct(node, in_place_node_t(), std::forward<Args>(args)...);
+		link_type parent;
+		bool insertLeft;
+		if (!_unique_pos(_keyOfValue(node->_value), parent, insertLeft)) {
+			_put_node(node);
+			return std::pair<iterator, bool>(parent, false);
 		}
-		else {
-			std::pair<iterator, bool> ret;
-			_header->_parent = _put_unique(_header->_parent, _header, x, ret);
-			_header->_parent->_parent = _header;
-			_adjust_header_insert(ret.first._Ptr());
-			return ret;
+		return std::pair<iterator, bool>(_link_node(parent, insertLeft, node), true);
+	}
+
+	//Links the handle's node without copying it. A duplicate leaves the node in the returned handle.
+	insert_return_type insert_unique(node_handle &&nh) {
+		if (nh.empty())
+			return insert_return_type{ end(), false, node_handle() };
+		if (!(nh._alloc == _alloc))
+			throw std::exception("");
+		link_type parent;
+		bool insertLeft;
+		if (!_unique_pos(_keyOfValue(nh._node->_value), parent, insertLeft))
+			return insert_return_type{ iterator(parent), false, std::move(nh) };
+		return insert_return_type{ _link_detached(parent, insertLeft, nh._release()), true, node_handle() };
+	}
+
+	iterator insert_equal(node_handle &&nh) {
+		if (nh.empty())
+			return end();
+		if (!(nh._alloc == _alloc))
+			throw std::exception("");
+		link_type parent;
+		bool insertLeft;
+		_equal_pos(nh._node->_value, parent, insertLeft);
+		return _link_detached(parent, insertLeft, nh._release());
+	}
+
+	//unlinks the node without destroying its value
+	node_handle extract(iterator position) {
+		return node_handle(_unlink(position._Ptr()), _alloc);
+	}
+
+	node_handle extract(const key_type &k) {
+		iterator it = _find(k);
+		if (it == end())
+			return node_handle();
+		return extract(it);
+	}
+
+	//Moves every node of x whose key is absent here; the nodes themselves are relinked, nothing is allocated or copied.
+	//Only when the allocators differ are the values copied instead.
+	void merge_unique(RBtree &x) {
+		if (this == &x)
+			return;
+		bool relink = _alloc == x._alloc;
+		iterator it = x.begin();
+		while (it != x.end()) {
+			link_type node = it._Ptr();
+			++it;
+			link_type parent;
+			bool insertLeft;
+			if (!_unique_pos(_keyOfValue(node->_value), parent, insertLeft))
+				continue;
+			if (relink)
+				_link_detached(parent, insertLeft, x._unlink(node));
+			else {
+				_insert_node(parent, insertLeft, node->_value);
+				x.erase(iterator(node));
+			}
+		}
+	}
+
+	void merge_equal(RBtree &x) {
+		if (this == &x)
+			return;
+		if (!(_alloc == x._alloc)) {
+			insert_equal(x.begin(), x.end());
+			x.clear();
+			return;
 		}
+		while (x._size)
+			insert_equal(x.extract(x.begin()));
+	}
+
+	//the value is built inside the node, then the node is linked after any equal keys
+	template<typename... Args>
+	iterator emplace_equal(Args&&... args) {
+		link_type node = _get_node();
+		_alloc.construct(node, in_place_node_t(), std::forward<Args>(args)...);
+		link_type parent;
+		bool insertLeft;
+		_equal_pos(node->_value, parent, insertLeft);
+		return _link_node(parent, insertLeft, node);
 	}
 
 	iterator insert_equal(const value_type &x) {
-		if (_size == 0) {
-			_header->_left = _header->_right = _header->_parent = _alloc.allocate(1);
-			_alloc.construct(_header->_parent, x, _header, nullptr, nullptr, BLACK);
-			++_size;
-			return iterator(_header->_parent);
+		link_type parent;
+		bool insertLeft;
+		_equal_pos(x, parent, insertLeft);
+		return _insert_node(parent, insertLeft, x);
+	}
+
+	//Amortized O(1) when x belongs right before or right after position, otherwise falls back to a full descent.
+	iterator insert_unique(iterator position, const value_type &x) {
+		link_type parent;
+		bool insertLeft;
+		if (!_hint_unique_pos(position, _keyOfValue(x), parent, insertLeft))
+			return parent;
+		return _insert_node(parent, insertLeft, x);
+	}
+
+	//the hinted counterpart of emplace_unique
+	template<typename... Args>
+	iterator emplace_hint_unique(iterator position, Args&&... args) {
+		link_type node = _get_node();
+		_alloc.construct(node, in_place_node_t(), std::forward<Args>(args)...);
+		link_type parent;
+		bool insertLeft;
+		if (!_hint_unique_pos(position, _keyOfValue(node->_value), parent, insertLeft)) {
+			_put_node(node);
+			return parent;
 		}
-		else {
-			iterator ret;
-			_header->_parent = _put_equal(_header->_parent, _header, x, ret);
-			_header->_parent->_parent = _header;
-			_adjust_header_insert(ret._Ptr());
-			return ret;
+		return _link_node(parent, insertLeft, node);
+	}
+
+	//the hinted counterpart of emplace_unique_key
+	template<typename K, typename... Args>
+	std::pair<iterator, bool> emplace_hint_unique_key(iterator position, const K &k, Args&&... args) {
+		link_type parent;
+		bool insertLeft;
+		if (!_hint_unique_pos(position, k, parent, insertLeft))
+			return std::pair<iterator, bool>(parent, false);
+		return std::pair<iterator, bool>(_insert_node(parent, insertLeft, std::forward<Args>(args)...), true);
+	}
+
+	//x goes as close as possible before position
+	iterator insert_equal(iterator position, const value_type &x) {
+		link_type parent;
+		bool insertLeft;
+		_hint_equal_pos(position, x, parent, insertLeft);
+		return _insert_node(parent, insertLeft, x);
+	}
+
+	template<typename... Args>
+	iterator emplace_hint_equal(iterator position, Args&&... args) {
+		link_type node = _get_node();
+		_alloc.construct(node, in_place_node_t(), std::forward<Args>(args)...);
+		link_type parent;
+		bool insertLeft;
+		_hint_equal_pos(position, node->_value, parent, insertLeft);
+		return _link_node(parent, insertLeft, node);
+	}
+
+	//Sorted input into an empty tree is built directly, otherwise each element is hinted with the previous one,
+	//so sorted runs never descend from the root.
+	template<typename InputIterator>
+	void insert_unique(InputIterator first, InputIterator last) {
+		if (empty() && _build_if_sorted(first, last, true, typename std::iterator_traits<InputIterator>::iterator_category()))
+			return;
+		iterator hint = end();
+		while (first != last) {
+			hint = insert_unique(hint, *first);
+			++first;
+		}
+	}
+
+	//hinting with end() keeps equal keys in input order, and sorted input still appends in O(1)
+	template<typename InputIterator>
+	void insert_equal(InputIterator first, InputIterator last) {
+		if (empty() && _build_if_sorted(first, last, false, typename std::iterator_traits<InputIterator>::iterator_category()))
+			return;
+		while (first != last) {
+			insert_equal(end(), *first);
+			++first;
 		}
 	}
 
@@ -267,11 +659,11 @@ public:
 		return _size;
 	}
 
-	value_type max()const {
+	const value_type& max()const {
 		return _header->_right->_value;
 	}
 
-	value_type min()const {
+	const value_type& min()const {
 		return _header->_left->_value;
 	}
 
@@ -283,36 +675,91 @@ public:
 		return _header;
 	}
 
+	//for wrappers that search the node structure themselves, nullptr when empty
+	link_type root()const {
+		return _root();
+	}
+
+	Compare key_comp()const {
+		return _keyCompare;
+	}
+
+	allocator_type get_allocator()const {
+		return _alloc;
+	}
+
 	void assign(const RBtree &x, bool repeat) {
+		if (this == &x)
+			return;
 		clear();
-		if (repeat) {
-			for (auto it = x.begin(); it != x.end(); ++it)
-				insert_equal(*it);
-		}
-		else {
-			for (auto it = x.begin(); it != x.end(); ++it)
-				insert_unique(*it);
-		}
+		_copy_from(x);
 	}
 
 	void assign(std::initializer_list<value_type> il, bool repeat) {
 		clear();
-		if (repeat) {
-			for (auto it = il.begin(); it != il.end(); ++it)
-				insert_equal(*it);
+		if (repeat)
+			insert_equal(il.begin(), il.end());
+		else
+			insert_unique(il.begin(), il.end());
+	}
+
+	iterator erase(iterator position) {
+		link_type pos = position._Ptr();
+		++position;
+		_put_node(_unlink(pos));
+		return position;
+	}
+
+	iterator erase(iterator first, iterator last) {
+		if (first == begin() && last == end()) {
+			clear();
+			return end();
 		}
-		else {
-			for (auto it = il.begin(); it != il.end(); ++it)
-				insert_unique(*it);
+		while (first != last)
+			first = erase(first);
+		return last;
+	}
+
+	size_type erase(const key_type &k) {
+		std::pair<link_type, link_type> range = _equal_range(k);
+		iterator first = range.first;
+		iterator last = range.second;
+		if (first == begin() && last == end()) {
+			size_type n = _size;
+			clear();
+			return n;
+		}
+		size_type n = 0;
+		while (first != last) {
+			first = erase(first);
+			++n;
 		}
+		return n;
 	}
 
+	//also gives the free list back to the allocator
 	void clear() {
-		if (_size == 0)
+		if (_size == 0 && !_freeList)
 			return;
-		_clear_aux(_header->_parent);
-		_header->_parent = _header->_left = _header->_right = _header;
-		_size = 0;
+		if (_release_all()) {
+			_init_header();
+			return;
+		}
+		if (_size != 0) {
+			_clear_aux(_header->parent());
+			_header->_left = _header->_right = _header;
+			_header->set_parent(_header);
+			_size = 0;
+		}
+		shrink_to_fit();
+	}
+
+	void shrink_to_fit() {
+		while (_freeList) {
+			link_type next = _freeList->_right;
+			_alloc.deallocate(_freeList, 1);
+			_freeList = next;
+		}
 	}
 
 	bool empty()const {
@@ -322,131 +769,114 @@ public:
 	void swap(RBtree &x) {
 		link_type tmp_header = _header;
 		size_type tmp_size = _size;
+		link_type tmp_freeList = _freeList;
 		_header = x._header;
 		_size = x._size;
+		_freeList = x._freeList;
 		x._header = tmp_header;
 		x._size = tmp_size;
+		x._freeList = tmp_freeList;
+		std::swap(_keyCompare, x._keyCompare);
+		std::swap(_alloc, x._alloc);
 	}
 
-	iterator find(const key_type &key)const {
-		if (empty())
-			return end();
-		link_type h = _header->_parent;
-		while (h) {
-			if (_is_equal_keyval(key,h->_value))
-				return h;
-			else if (_do_compare_keyval(key, h->_value))
-				h = h->_left;
-			else
-				h = h->_right;
-		}
-		return end();
-	}
-
-	//iterator lower_bound(const value_type &x)const {
-	//	if (empty())
-	//		return end();
-	//	if (_do_compare(max(), x))
-	//		return end();
-	//	link_type h = _header->_parent;
-	//	link_type res = nullptr;
-	//	while (h) {
-	//		if (_is_equal(x, h->_value))
-	//			return h;
-	//		else if (_do_compare(x, h->_value)) {
-	//			if (!res)
-	//				res = h;
-	//			else
-	//				res = _do_compare(h->_value, res->_value) ? h : res;
-	//			h = h->_left;
-	//		}
-	//		else {
-	//			h = h->_right;
-	//		}
-	//	}
-	//	return res;
-	//}
-
-	//iterator upper_bound(const value_type &x)const {
-	//	if (empty())
-	//		return end();
-	//	if (_do_compare(max(), x) || _is_equal(max(), x))
-	//		return end();
-	//	link_type h = _header->_parent;
-	//	link_type res = nullptr;
-	//	while (h) {
-	//		if (_is_equal(x, h->_value)) {
-	//			iterator it(h);
-	//			++it;
-	//			return it;
-	//		}
-	//		else if (_do_compare(x, h->_value)) {
-	//			if (!res)
-	//				res = h;
-	//			else
-	//				res = _do_compare(h->_value, res->_value) ? h : res;
-	//			h = h->_left;
-	//		}
-	//		else {
-	//			h = h->_right;
-	//		}
-	//	}
-	//	return res;
-	//}
+	iterator find(const key_type &k)const {
+		return _find(k);
+	}
 
 	iterator lower_bound(const key_type &k)const {
-		if (empty())
-			return end();
-		if (_do_compare_valkey(max(), k))
+		return _lower_bound(k);
+	}
+
+	iterator upper_bound(const key_type &k)const {
+		return _upper_bound(k);
+	}
+
+	//the overloads below take any type the comparator accepts, only when Compare declares is_transparent
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &k)const {
+		return _find(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &k)const {
+		return _lower_bound(k);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &k)const {
+		return _upper_bound(k);
+	}
+
+	std::pair<iterator, iterator> equal_range(const key_type &k)const {
+		std::pair<link_type, link_type> range = _equal_range(k);
+		return std::pair<iterator, iterator>(range.first, range.second);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	std::pair<iterator, iterator> equal_range(const K &k)const {
+		std::pair<link_type, link_type> range = _equal_range(k);
+		return std::pair<iterator, iterator>(range.first, range.second);
+	}
+
+	//Number of elements with key k. O(log n) with subtree counts, otherwise O(log n + count) by walking the range.
+	template<typename K>
+	size_type count_equal(const K &k)const {
+		return _count_equal(k, std::integral_constant<bool, has_subtree_count<node_type>::value>());
+	}
+
+	//The queries below need a node type that keeps subtree sizes, such as counted_RBtree_node.
+	//k-th element in order, end() when k >= size()
+	iterator nth(size_type k)const {
+		static_assert(has_subtree_count<node_type>::value, "nth needs a node type with subtree counts");
+		if (k >= _size)
 			return end();
-		link_type h = _header->_parent;
-		link_type res = nullptr;
-		while (h) {
-			if (_is_equal_keyval(k, h->_value))
+		link_type h = _root();
+		while (true) {
+			size_type leftCount = _count_of(h->_left);
+			if (k == leftCount)
 				return h;
-			else if (_do_compare_keyval(k, h->_value)) {
-				if (!res)
-					res = h;
-				else
-					res = _do_compare_valval(h->_value, res->_value) ? h : res;
+			if (k < leftCount)
 				h = h->_left;
-			}
 			else {
+				k -= leftCount + 1;
 				h = h->_right;
 			}
 		}
-		return res;
 	}
 
-	iterator upper_bound(const key_type &k)const {
-		if (empty())
-			return end();
-		if (_do_compare_valkey(max(), k) || _is_equal_keyval(k, max()))
-			return end();
-		link_type h = _header->_parent;
-		link_type res = nullptr;
+	//number of elements whose key is less than k
+	template<typename K>
+	size_type rank(const K &k)const {
+		static_assert(has_subtree_count<node_type>::value, "rank needs a node type with subtree counts");
+		size_type res = 0;
+		link_type h = _root();
 		while (h) {
-			if (_is_equal_keyval(k, h->_value)) {
-				iterator it(h);
-				++it;
-				return it;
-			}
-			else if (_do_compare_keyval(k, h->_value)) {
-				if (!res)
-					res = h;
-				else
-					res = _do_compare_valval(h->_value, res->_value) ? h : res;
-				h = h->_left;
-			}
-			else {
+			if (_do_compare_valkey(h->_value, k)) {
+				res += _count_of(h->_left) + 1;
 				h = h->_right;
 			}
+			else
+				h = h->_left;
 		}
 		return res;
 	}
 
+	//number of elements with keys in [lo, hi)
+	template<typename K>
+	size_type count_range(const K &lo, const K &hi)const {
+		if (!_keyCompare(lo, hi))
+			return 0;
+		return rank(hi) - rank(lo);
+	}
+
+	//bytes each node spends on links and color beyond the value itself
+	static size_type node_overhead() {
+		return sizeof(node_type) - sizeof(value_type);
+	}
+
 	void print_tree()const {
-		print_tree(_header->_parent);
+		print_tree(_header->parent());
 		std::cout << "size: " << size() << std::endl;
 		std::cout << "max: " << max() << std::endl;
 		std::cout << "min: " << min() << std::endl;
@@ -461,135 +891,704 @@ public:
 	}
 private:
 	void _init_header() {
+		_size = 0;
+		_freeList = nullptr;
 		_header = _alloc.allocate(1);
-		_header->_color = RED;
-		_header->_parent = _header;
+		_header->set_parent(_header);
+		_header->set_color(RED);
 		_header->_left = _header;
 		_header->_right = _header;
 	}
 
-	link_type _put_unique(link_type root, link_type parent, const value_type &x, std::pair<iterator, bool> &ret) {
-		if (!root) {
-			link_type newNode = _alloc.allocate(1);
-			_alloc.construct(newNode, x, parent);
-			ret.first = iterator(newNode);
-			ret.second = true;
-			++_size;
-			return newNode;
+	link_type _root()const {
+		return _size ? _header->parent() : nullptr;
+	}
+
+	//With trivially destructible values and a pool that no one else draws from, whole chunks go back at once,
+	//the header included.
+	bool _release_all() {
+		return _release_all(std::integral_constant<bool, std::is_trivially_destructible<value_type>::value && has_release<allocator_type>::value>());
+	}
+
+	bool _release_all(std::true_type) {
+		return _alloc.release();
+	}
+
+	bool _release_all(std::false_type) {
+		return false;
+	}
+
+	void _copy_from(const RBtree &x) {
+		if (x._size == 0)
+			return;
+		_header->set_parent(_clone(x._header->parent(), _header));
+		_set_extremes();
+		_size = x._size;
+	}
+
+	//recurses on right children only and walks the left spine in the loop, like _clear_aux
+	link_type _clone(link_type x, link_type parent) {
+		link_type top = _clone_node(x, parent);
+		if (x->_right)
+			top->_right = _clone(x->_right, top);
+		parent = top;
+		x = x->_left;
+		while (x) {
+			link_type node = _clone_node(x, parent);
+			parent->_left = node;
+			if (x->_right)
+				node->_right = _clone(x->_right, node);
+			parent = node;
+			x = x->_left;
+		}
+		_augment_path(parent, top->parent());
+		return top;
+	}
+
+	link_type _clone_node(link_type x, link_type parent) {
+		link_type node = _get_node();
+		_alloc.construct(node, x->_value, parent, nullptr, nullptr, x->color());
+		return node;
+	}
+
+	template<typename InputIterator>
+	bool _build_if_sorted(InputIterator, InputIterator, bool, std::input_iterator_tag) {
+		return false;
+	}
+
+	//one pass to count and check the order, strict for unique keys; gives up at the first pair out of order
+	template<typename ForwardIterator>
+	bool _build_if_sorted(ForwardIterator first, ForwardIterator last, bool strict, std::forward_iterator_tag) {
+		if (first == last)
+			return true;
+		size_type n = 1;
+		ForwardIterator pre = first;
+		for (ForwardIterator it = std::next(first); it != last; ++it, ++pre, ++n) {
+			if (strict ? !_do_compare_valval(*pre, *it) : _do_compare_valval(*it, *pre))
+				return false;
+		}
+		size_type depth = 0;
+		while ((n >> (depth + 1)) != 0)
+			++depth;
+		_header->set_parent(_build_sorted(first, n, _header, depth == 0 ? size_type(-1) : depth, 0));
+		_set_extremes();
+		_size = n;
+		return true;
+	}
+
+	//Splits at the middle, so every empty link sits on the last two levels. Painting the deepest level red
+	//keeps the black height equal on all paths without a single comparison.
+	template<typename ForwardIterator>
+	link_type _build_sorted(ForwardIterator &first, size_type n, link_type parent, size_type redDepth, size_type depth) {
+		if (n == 0)
+			return nullptr;
+		size_type leftSize = (n - 1) / 2;
+		link_type left = _build_sorted(first, leftSize, nullptr, redDepth, depth + 1);
+		link_type node = _get_node();
+		_alloc.construct(node, *first, parent, left, nullptr, depth == redDepth ? RED : BLACK);
+		++first;
+		if (left)
+			left->set_parent(node);
+		node->_right = _build_sorted(first, n - 1 - leftSize, node, redDepth, depth + 1);
+		_augment(node);
+		return node;
+	}
+
+	void _set_extremes() {
+		link_type h = _header->parent();
+		while (h->_left)
+			h = h->_left;
+		_header->_left = h;
+		h = _header->parent();
+		while (h->_right)
+			h = h->_right;
+		_header->_right = h;
+	}
+
+	//a lower_bound descent plus one comparison at the end
+	template<typename K>
+	link_type _find(const K &k)const {
+		link_type res = _lower_bound(k);
+		if (res == _header || _do_compare_keyval(k, res->_value))
+			return _header;
+		return res;
+	}
+
+	//first node whose key is not less than k
+	template<typename K>
+	link_type _lower_bound(const K &k)const {
+		link_type res = _header;
+		link_type h = _root();
+		while (h) {
+			if (_do_compare_valkey(h->_value, k))
+				h = h->_right;
+			else {
+				res = h;
+				h = h->_left;
+			}
+		}
+		return res;
+	}
+
+	//first node whose key is greater than k
+	template<typename K>
+	link_type _upper_bound(const K &k)const {
+		link_type res = _header;
+		link_type h = _root();
+		while (h) {
+			if (_do_compare_keyval(k, h->_value)) {
+				res = h;
+				h = h->_left;
+			}
+			else
+				h = h->_right;
+		}
+		return res;
+	}
+
+	//Descends until the first node with key k, then finishes the lower bound in its left subtree and the upper
+	//bound in its right subtree, so both bounds cost one root-to-leaf walk.
+	template<typename K>
+	std::pair<link_type, link_type> _equal_range(const K &k)const {
+		link_type lower = _header;
+		link_type upper = _header;
+		link_type h = _root();
+		while (h) {
+			if (_do_compare_valkey(h->_value, k))
+				h = h->_right;
+			else if (_do_compare_keyval(k, h->_value)) {
+				lower = upper = h;
+				h = h->_left;
+			}
+			else {
+				link_type r = h->_right;
+				lower = h;
+				for (h = h->_left; h; ) {
+					if (_do_compare_valkey(h->_value, k))
+						h = h->_right;
+					else {
+						lower = h;
+						h = h->_left;
+					}
+				}
+				while (r) {
+					if (_do_compare_keyval(k, r->_value)) {
+						upper = r;
+						r = r->_left;
+					}
+					else
+						r = r->_right;
+				}
+				break;
+			}
+		}
+		return std::pair<link_type, link_type>(lower, upper);
+	}
+
+	//the equal nodes in the two subtrees of the first one found are summed from the subtree counts
+	template<typename K>
+	size_type _count_equal(const K &k, std::true_type)const {
+		link_type h = _root();
+		while (h) {
+			if (_do_compare_valkey(h->_value, k))
+				h = h->_right;
+			else if (_do_compare_keyval(k, h->_value))
+				h = h->_left;
+			else {
+				size_type n = 1;
+				for (link_type l = h->_left; l; ) {
+					if (_do_compare_valkey(l->_value, k))
+						l = l->_right;
+					else {
+						n += _count_of(l->_right) + 1;
+						l = l->_left;
+					}
+				}
+				for (link_type r = h->_right; r; ) {
+					if (_do_compare_keyval(k, r->_value))
+						r = r->_left;
+					else {
+						n += _count_of(r->_left) + 1;
+						r = r->_right;
+					}
+				}
+				return n;
+			}
+		}
+		return 0;
+	}
+
+	template<typename K>
+	size_type _count_equal(const K &k, std::false_type)const {
+		std::pair<link_type, link_type> range = _equal_range(k);
+		size_type n = 0;
+		for (iterator it = range.first; it != iterator(range.second); ++it)
+			++n;
+		return n;
+	}
+
+	//after the keys equal to x
+	void _equal_pos(const value_type &x, link_type &parent, bool &insertLeft)const {
+		parent = _header;
+		link_type h = _root();
+		insertLeft = true;
+		while (h) {
+			parent = h;
+			insertLeft = _do_compare_valval(x, h->_value);
+			h = insertLeft ? h->_left : h->_right;
+		}
+	}
+
+	//in front of the keys equal to x, for hints that lie before the equal range
+	void _equal_lower_pos(const value_type &x, link_type &parent, bool &insertLeft)const {
+		parent = _header;
+		link_type h = _root();
+		insertLeft = true;
+		while (h) {
+			parent = h;
+			insertLeft = !_do_compare_valval(h->_value, x);
+			h = insertLeft ? h->_left : h->_right;
+		}
+	}
+
+	//Like _unique_pos, but checks the slots right before and right after position first.
+	template<typename K>
+	bool _hint_unique_pos(iterator position, const K &k, link_type &parent, bool &insertLeft)const {
+		link_type pos = position._Ptr();
+		if (pos == _header) {
+			if (_size && _do_compare_valkey(_header->_right->_value, k)) {
+				parent = _header->_right;
+				insertLeft = false;
+				return true;
+			}
+			return _unique_pos(k, parent, insertLeft);
+		}
+		if (_do_compare_keyval(k, pos->_value)) {
+			if (pos == _header->_left) {
+				parent = pos;
+				insertLeft = true;
+				return true;
+			}
+			iterator before = position;
+			--before;
+			if (_do_compare_valkey(*before, k)) {
+				insertLeft = before._Ptr()->_right != nullptr;
+				parent = insertLeft ? pos : before._Ptr();
+				return true;
+			}
+			return _unique_pos(k, parent, insertLeft);
+		}
+		if (_do_compare_valkey(pos->_value, k)) {
+			if (pos == _header->_right) {
+				parent = pos;
+				insertLeft = false;
+				return true;
+			}
+			iterator after = position;
+			++after;
+			if (_do_compare_keyval(k, *after)) {
+				insertLeft = pos->_right != nullptr;
+				parent = insertLeft ? after._Ptr() : pos;
+				return true;
+			}
+			return _unique_pos(k, parent, insertLeft);
+		}
+		parent = pos;
+		return false;
+	}
+
+	//as close as possible before position
+	void _hint_equal_pos(iterator position, const value_type &x, link_type &parent, bool &insertLeft)const {
+		link_type pos = position._Ptr();
+		if (pos == _header) {
+			if (_size && !_do_compare_valval(x, _header->_right->_value)) {
+				parent = _header->_right;
+				insertLeft = false;
+			}
+			else
+				_equal_pos(x, parent, insertLeft);
+			return;
 		}
-		if (!_do_compare_valval(x, root->_value) && !_do_compare_valval(root->_value, x)) {
-			ret.first = root;
-			ret.second = false;
-			return root;
+		if (!_do_compare_valval(pos->_value, x)) {
+			if (pos == _header->_left) {
+				parent = pos;
+				insertLeft = true;
+				return;
+			}
+			iterator before = position;
+			--before;
+			if (!_do_compare_valval(x, *before)) {
+				insertLeft = before._Ptr()->_right != nullptr;
+				parent = insertLeft ? pos : before._Ptr();
+			}
+			else
+				_equal_pos(x, parent, insertLeft);
+			return;
+		}
+		if (pos == _header->_right) {
+			parent = pos;
+			insertLeft = false;
+			return;
+		}
+		iterator after = position;
+		++after;
+		if (!_do_compare_valval(*after, x)) {
+			insertLeft = pos->_right != nullptr;
+			parent = insertLeft ? after._Ptr() : pos;
 		}
-		else if (_do_compare_valval(x, root->_value))
-			root->_left = _put_unique(root->_left, root, x, ret);
 		else
-			root->_right = _put_unique(root->_right, root, x, ret);
-		if (!_is_red(root->_left) && _is_red(root->_right))
-			root = _rotate_left(root);
-		if (_is_red(root->_left) && _is_red(root->_left->_left))
-			root = _rotate_right(root);
-		if (_is_red(root->_left) && _is_red(root->_right))
-			_flip_colors(root);
-		return root;
-	}
-
-	link_type _put_equal(link_type root, link_type parent, const value_type &x, iterator &ret) {
-		if (!root) {
-			link_type newNode = _alloc.allocate(1);
-			_alloc.construct(newNode, x, parent);
-			ret = iterator(newNode);
-			++_size;
-			return newNode;
-		}
-		if (_do_compare_valval(x, root->_value))
-			root->_left = _put_equal(root->_left, root, x, ret);
+			_equal_lower_pos(x, parent, insertLeft);
+	}
+
+	//the value is built in place from args
+	template<typename... Args>
+	iterator _insert_node(link_type parent, bool insertLeft, Args&&... args) {
+		link_type newNode = _get_node();
+		_alloc.construct(newNode, in_place_node_t(), std::forward<Args>(args)...);
+		return _link_node(parent, insertLeft, newNode);
+	}
+
+	//a node that was linked before carries stale links, color and summary
+	iterator _link_detached(link_type parent, bool insertLeft, link_type node) {
+		node->_left = node->_right = nullptr;
+		node->set_color(RED);
+		_augment(node);
+		return _link_node(parent, insertLeft, node);
+	}
+
+	//parent is _header only for the first node
+	iterator _link_node(link_type parent, bool insertLeft, link_type newNode) {
+		newNode->set_parent(parent);
+		if (parent == _header) {
+			_header->_left = _header->_right = newNode;
+			_header->set_parent(newNode);
+		}
+		else if (insertLeft) {
+			parent->_left = newNode;
+			if (parent == _header->_left)
+				_header->_left = newNode;
+		}
+		else {
+			parent->_right = newNode;
+			if (parent == _header->_right)
+				_header->_right = newNode;
+		}
+		_augment_path(parent, _header);
+		_rebalance_insert(newNode);
+		++_size;
+		return newNode;
+	}
+
+	//Finds where a node keyed k would hang. When k is already present returns false, with parent set to that node.
+	template<typename K>
+	bool _unique_pos(const K &k, link_type &parent, bool &insertLeft)const {
+		parent = _header;
+		link_type h = _root();
+		insertLeft = true;
+		while (h) {
+			parent = h;
+			insertLeft = _do_compare_keyval(k, h->_value);
+			h = insertLeft ? h->_left : h->_right;
+		}
+		//only the in-order predecessor of the landing spot can hold an equal key
+		iterator pre(parent);
+		if (insertLeft) {
+			if (parent == _header->_left)
+				return true;
+			--pre;
+		}
+		if (_do_compare_valkey(*pre, k))
+			return true;
+		parent = pre._Ptr();
+		return false;
+	}
+
+	//takes the node out of the tree, leaving its value alive
+	link_type _unlink(link_type pos) {
+		link_type node = _rebalance_erase(pos);
+		if (--_size == 0) {
+			_header->_left = _header->_right = _header;
+			_header->set_parent(_header);
+		}
+		return node;
+	}
+
+	link_type _get_node() {
+		if (!_freeList)
+			return _alloc.allocate(1);
+		link_type node = _freeList;
+		_freeList = node->_right;
+		return node;
+	}
+
+	void _put_node(link_type node) {
+		_alloc.destroy(node);
+		node->_right = _freeList;
+		_freeList = node;
+	}
+
+	//Unlinks z and restores the red-black invariants. A node with two children is replaced by its successor,
+	//which takes over z's color, so the fixup only runs when a black node left the tree.
+	link_type _rebalance_erase(link_type z) {
+		link_type y = z;
+		link_type x = nullptr;
+		link_type xParent = nullptr;
+		if (!y->_left)
+			x = y->_right;
+		else if (!y->_right)
+			x = y->_left;
+		else {
+			y = y->_right;
+			while (y->_left)
+				y = y->_left;
+			x = y->_right;
+		}
+		if (y != z) {
+			z->_left->set_parent(y);
+			y->_left = z->_left;
+			if (y != z->_right) {
+				xParent = y->parent();
+				if (x)
+					x->set_parent(y->parent());
+				y->parent()->_left = x;
+				y->_right = z->_right;
+				z->_right->set_parent(y);
+			}
+			else
+				xParent = y;
+			_replace_child(z, y);
+			y->set_parent(z->parent());
+			color_type yColor = y->color();
+			y->set_color(z->color());
+			z->set_color(yColor);
+			y = z;
+		}
+		else {
+			xParent = y->parent();
+			if (x)
+				x->set_parent(y->parent());
+			_replace_child(z, x);
+			if (_header->_left == z) {
+				if (!z->_right)
+					_header->_left = z->parent();
+				else {
+					_header->_left = x;
+					while (_header->_left->_left)
+						_header->_left = _header->_left->_left;
+				}
+			}
+			if (_header->_right == z) {
+				if (!z->_left)
+					_header->_right = z->parent();
+				else {
+					_header->_right = x;
+					while (_header->_right->_right)
+						_header->_right = _header->_right->_right;
+				}
+			}
+		}
+		_augment_path(xParent, _header);
+		if (y->color() == RED)
+			return y;
+		while (x != _header->parent() && !_is_red(x)) {
+			if (x == xParent->_left) {
+				link_type w = xParent->_right;
+				if (w->color() == RED) {
+					w->set_color(BLACK);
+					xParent->set_color(RED);
+					_rotate_left(xParent);
+					w = xParent->_right;
+				}
+				if (!_is_red(w->_left) && !_is_red(w->_right)) {
+					w->set_color(RED);
+					x = xParent;
+					xParent = xParent->parent();
+					continue;
+				}
+				if (!_is_red(w->_right)) {
+					w->_left->set_color(BLACK);
+					w->set_color(RED);
+					_rotate_right(w);
+					w = xParent->_right;
+				}
+				w->set_color(xParent->color());
+				xParent->set_color(BLACK);
+				if (w->_right)
+					w->_right->set_color(BLACK);
+				_rotate_left(xParent);
+				break;
+			}
+			else {
+				link_type w = xParent->_left;
+				if (w->color() == RED) {
+					w->set_color(BLACK);
+					xParent->set_color(RED);
+					_rotate_right(xParent);
+					w = xParent->_left;
+				}
+				if (!_is_red(w->_right) && !_is_red(w->_left)) {
+					w->set_color(RED);
+					x = xParent;
+					xParent = xParent->parent();
+					continue;
+				}
+				if (!_is_red(w->_left)) {
+					w->_right->set_color(BLACK);
+					w->set_color(RED);
+					_rotate_left(w);
+					w = xParent->_left;
+				}
+				w->set_color(xParent->color());
+				xParent->set_color(BLACK);
+				if (w->_left)
+					w->_left->set_color(BLACK);
+				_rotate_right(xParent);
+				break;
+			}
+		}
+		if (x)
+			x->set_color(BLACK);
+		return y;
+	}
+
+	//hangs child where node was, node->parent() is left untouched
+	void _replace_child(link_type node, link_type child) {
+		if (node == _header->parent())
+			_header->set_parent(child);
+		else if (node == node->parent()->_left)
+			node->parent()->_left = child;
 		else
-			root->_right = _put_equal(root->_right, root, x, ret);
-		if (!_is_red(root->_left) && _is_red(root->_right))
-			root = _rotate_left(root);
-		if (_is_red(root->_left) && _is_red(root->_left->_left))
-			root = _rotate_right(root);
-		if (_is_red(root->_left) && _is_red(root->_right))
-			_flip_colors(root);
-		return root;
+			node->parent()->_right = child;
+	}
+
+	//bottom-up fixup: recolor while the uncle is red, then at most two rotations
+	void _rebalance_insert(link_type x) {
+		while (x != _header->parent() && x->parent()->color() == RED) {
+			link_type p = x->parent();
+			link_type g = p->parent();
+			if (p == g->_left) {
+				link_type uncle = g->_right;
+				if (_is_red(uncle)) {
+					p->set_color(BLACK);
+					uncle->set_color(BLACK);
+					g->set_color(RED);
+					x = g;
+					continue;
+				}
+				if (x == p->_right) {
+					_rotate_left(p);
+					p = x;
+				}
+				p->set_color(BLACK);
+				g->set_color(RED);
+				_rotate_right(g);
+				break;
+			}
+			else {
+				link_type uncle = g->_left;
+				if (_is_red(uncle)) {
+					p->set_color(BLACK);
+					uncle->set_color(BLACK);
+					g->set_color(RED);
+					x = g;
+					continue;
+				}
+				if (x == p->_left) {
+					_rotate_right(p);
+					p = x;
+				}
+				p->set_color(BLACK);
+				g->set_color(RED);
+				_rotate_left(g);
+				break;
+			}
+		}
+		_header->parent()->set_color(BLACK);
 	}
 
 	bool _is_red(link_type node)const {
 		if (!node)
 			return false;
-		return node->_color == RED;
+		return node->color() == RED;
 	}
 
-	link_type _rotate_left(link_type h) {
+	void _rotate_left(link_type h) {
 		link_type tmp = h->_right;
 		h->_right = tmp->_left;
-		if(tmp->_left)
-			tmp->_left->_parent = h;
+		if (tmp->_left)
+			tmp->_left->set_parent(h);
+		tmp->set_parent(h->parent());
+		_replace_child(h, tmp);
 		tmp->_left = h;
-		tmp->_parent = h->_parent;
-		h->_parent = tmp;
-		tmp->_color = h->_color;
-		h->_color = RED;
-		return tmp;
+		h->set_parent(tmp);
+		_augment(h);
+		_augment(tmp);
 	}
 
-	link_type _rotate_right(link_type h) {
+	void _rotate_right(link_type h) {
 		link_type tmp = h->_left;
 		h->_left = tmp->_right;
-		if(tmp->_right)
-			tmp->_right->_parent = h;
+		if (tmp->_right)
+			tmp->_right->set_parent(h);
+		tmp->set_parent(h->parent());
+		_replace_child(h, tmp);
 		tmp->_right = h;
-		tmp->_parent = h->_parent;
-		h->_parent = tmp;
-		tmp->_color = h->_color;
-		h->_color = RED;
-		return tmp;
+		h->set_parent(tmp);
+		_augment(h);
+		_augment(tmp);
 	}
 
-	void _flip_colors(link_type h) {
-		h->_color = RED;
-		h->_left->_color = BLACK;
-		h->_right->_color = BLACK;
+	size_type _count_of(link_type node)const {
+		return node ? node->_count : 0;
 	}
 
-	void _adjust_header_insert(link_type h) {
-		if (_size == 1) {
-			_header->_parent = _header->_left = _header->_right = h;
-			h->_parent = _header;
-		}
-		else {
-			if (_do_compare_valval(h->_value, _header->_left->_value))
-				_header->_left = h;
-			else if(_do_compare_valval(_header->_right->_value,h->_value))
-				_header->_right = h;
-		}
-		_header->_parent->_color = BLACK;
+	//Augmentation hooks, they compile to nothing for plain nodes.
+	void _augment(link_type node) {
+		_augment(node, std::integral_constant<bool, is_augmented_node<node_type>::value>());
 	}
 
+	void _augment(link_type node, std::true_type) {
+		node->augment();
+	}
+
+	void _augment(link_type node, std::false_type) {}
+
+	//node and its ancestors below stop, after a node was linked or unlinked under node
+	void _augment_path(link_type node, link_type stop) {
+		_augment_path(node, stop, std::integral_constant<bool, is_augmented_node<node_type>::value>());
+	}
+
+	void _augment_path(link_type node, link_type stop, std::true_type) {
+		for (; node != stop; node = node->parent())
+			node->augment();
+	}
+
+	void _augment_path(link_type node, link_type stop, std::false_type) {}
+
 	bool _do_compare_valval(const value_type &lhs, const value_type &rhs)const {
 		return _keyCompare(_keyOfValue(lhs), _keyOfValue(rhs));
 	}
 
-	bool _do_compare_keyval(const key_type &key, const value_type &val)const {
+	template<typename K>
+	bool _do_compare_keyval(const K &key, const value_type &val)const {
 		return _keyCompare(key, _keyOfValue(val));
 	}
 
-	bool _do_compare_valkey(const value_type &val, const key_type &key)const {
+	template<typename K>
+	bool _do_compare_valkey(const value_type &val, const K &key)const {
 		return _keyCompare(_keyOfValue(val), key);
 	}
 
+	//recurses on right children only, the left spine is walked in the loop
 	void _clear_aux(link_type h) {
-		if (h->_left)
-			_clear_aux(h->_left);
-		if (h->_right)
-			_clear_aux(h->_right);
-		_alloc.deallocate(h, 1);
-	}
-
-	bool _is_equal_keyval(const key_type &key, const value_type &val)const {
-		return !_keyCompare(key, _keyOfValue(val)) && !_keyCompare(_keyOfValue(val), key);
+		while (h) {
+			if (h->_right)
+				_clear_aux(h->_right);
+			link_type left = h->_left;
+			_alloc.destroy(h);
+			_alloc.deallocate(h, 1);
+			h = left;
+		}
 	}
 };
 
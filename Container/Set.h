@@ -13,20 +13,23 @@ public:
 template<typename T,typename Compare=std::less<T>,typename Alloc = std::allocator<RBtree_node<T>>>
 class Set {
 public:
-	typedef T                                     key_type;
-	typedef T                                     value_type;
-	typedef Compare                               key_compare;
-	typedef Compare                               value_compare;
-	typedef Alloc                                 allocator_type;
-	typedef T&                                    reference;
-	typedef const T&                              const_reference;
-	typedef T*                                    pointer;
-	typedef const T*                              const_pointer;
-	typedef const_rb_tree_iterator<T, T&, T*>     iterator;
-	typedef std::reverse_iterator<iterator>       reverse_iterator;
-	typedef ptrdiff_t                             difference_type;
-	typedef size_t                                size_type;
-	typedef RBtree<T, T, identity<T>, Compare>    tree_type;
+	typedef T                                            key_type;
+	typedef T                                            value_type;
+	typedef Compare                                      key_compare;
+	typedef Compare                                      value_compare;
+	typedef Alloc                                        allocator_type;
+	typedef T&                                           reference;
+	typedef const T&                                     const_reference;
+	typedef T*                                           pointer;
+	typedef const T*                                     const_pointer;
+	typedef typename Alloc::value_type                   node_type;
+	typedef const_rb_tree_iterator<T, T&, T*, node_type> iterator;
+	typedef std::reverse_iterator<iterator>              reverse_iterator;
+	typedef ptrdiff_t                                    difference_type;
+	typedef size_t                                       size_type;
+	typedef RBtree<T, T, identity<T>, Compare, Alloc>    tree_type;
+	typedef typename tree_type::node_handle              node_handle;
+	typedef rb_tree_insert_return<iterator, node_handle> insert_return_type;
 private:
 	tree_type _tree;
 public:
@@ -79,24 +82,77 @@ public:
 		return -1;
 	}
 
+	static size_type node_overhead() {
+		return tree_type::node_overhead();
+	}
+
+	key_compare key_comp()const {
+		return _tree.key_comp();
+	}
+
+	allocator_type get_allocator()const {
+		return _tree.get_allocator();
+	}
+
 	std::pair<iterator, bool> insert(const value_type &val) {
 		return _tree.insert_unique(val);
 	}
 
+	iterator insert(iterator position, const value_type &val) {
+		return _tree.insert_unique(position, val);
+	}
+
 	template<typename InputIterator>
 	void insert(InputIterator first, InputIterator last) {
-		while (first != last) {
-			_tree.insert_unique(*first);
-			++first;
-		}
+		_tree.insert_unique(first, last);
 	}
 
 	void insert(std::initializer_list<value_type> il) {
-		auto it = il.begin();
-		while (it != il.end()) {
-			_tree.insert_unique(*it);
-			++it;
-		}
+		_tree.insert_unique(il.begin(), il.end());
+	}
+
+	//relinks the handle's node; on a duplicate the node comes back in the result
+	insert_return_type insert(node_handle &&nh) {
+		typename tree_type::insert_return_type res = _tree.insert_unique(std::move(nh));
+		return insert_return_type{ res.position, res.inserted, std::move(res.node) };
+	}
+
+	//on a duplicate nh keeps the node
+	iterator insert(iterator position, node_handle &&nh) {
+		typename tree_type::insert_return_type res = _tree.insert_unique(std::move(nh));
+		if (!res.inserted)
+			nh = std::move(res.node);
+		return res.position;
+	}
+
+	node_handle extract(iterator position) {
+		return _tree.extract(position);
+	}
+
+	//an empty handle when k is absent
+	node_handle extract(const key_type &k) {
+		return _tree.extract(k);
+	}
+
+	//moves the nodes of x whose elements are absent here, the rest stay in x
+	void merge(Set &x) {
+		_tree.merge_unique(x._tree);
+	}
+
+	void merge(Set &&x) {
+		_tree.merge_unique(x._tree);
+	}
+
+	iterator erase(iterator position) {
+		return _tree.erase(position);
+	}
+
+	size_type erase(const key_type &k) {
+		return _tree.erase(k);
+	}
+
+	iterator erase(iterator first, iterator last) {
+		return _tree.erase(first, last);
 	}
 
 	void swap(Set &x) {
@@ -107,10 +163,18 @@ public:
 		_tree.clear();
 	}
 
+	void shrink_to_fit() {
+		_tree.shrink_to_fit();
+	}
+
 	template<typename... Args>
 	std::pair<iterator, bool> emplace(Args&&... args) {
-		value_type val(args...);
-		return _tree.insert_unique(val);
+		return _tree.emplace_unique(std::forward<Args>(args)...);
+	}
+
+	template<typename... Args>
+	iterator emplace_hint(iterator position, Args&&... args) {
+		return _tree.emplace_hint_unique(position, std::forward<Args>(args)...);
 	}
 
 	iterator find(const value_type &x)const {
@@ -128,6 +192,49 @@ public:
 	iterator upper_bound(const value_type &x)const {
 		return _tree.upper_bound(x);
 	}
+
+	std::pair<iterator, iterator> equal_range(const value_type &x)const {
+		return _tree.equal_range(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator find(const K &x)const {
+		return _tree.find(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	size_type count(const K &x)const {
+		return _tree.find(x) != end();
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator lower_bound(const K &x)const {
+		return _tree.lower_bound(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	iterator upper_bound(const K &x)const {
+		return _tree.upper_bound(x);
+	}
+
+	template<typename K, typename C = Compare, typename = typename C::is_transparent>
+	std::pair<iterator, iterator> equal_range(const K &x)const {
+		return _tree.equal_range(x);
+	}
+
+	//the order statistics below need Alloc to hand out counted_RBtree_node
+	iterator nth(size_type n)const {
+		return _tree.nth(n);
+	}
+
+	size_type rank(const value_type &x)const {
+		return _tree.rank(x);
+	}
+
+	//elements in [lo, hi)
+	size_type count_range(const value_type &lo, const value_type &hi)const {
+		return _tree.count_range(lo, hi);
+	}
 };
 
 #endif // !SET_H
\ No newline at end of file
@@ -0,0 +1,163 @@
+#ifndef SETALGEBRA_H
+#define SETALGEBRA_H
+#include"Map.h"
+#include"Set.h"
+#include"Vector.h"
+
+//Every operation is one in-order merge of both trees into a sorted Vector, from which the result tree is built in
+//linear time. Where only matching keys matter, the side that falls behind gallops: a few steps in place, then one
+//lower_bound from the root, so a much smaller operand costs O(n log m) instead of O(n + m).
+//The results keep the first operand's comparator and allocator, and both operands must be ordered by equal comparators.
+constexpr size_t gallop_steps = 8;
+
+//first position at or after it whose key is not less than k
+template<typename Container, typename Iterator, typename Key, typename KeyOfValue, typename Compare>
+Iterator gallop_to(const Container &c, Iterator it, const Key &k, KeyOfValue keyOf, Compare comp) {
+	for (size_t i = 0; i < gallop_steps; ++i) {
+		if (it == c.end() || !comp(keyOf(*it), k))
+			return it;
+		++it;
+	}
+	return c.lower_bound(k);
+}
+
+template<typename T, typename Compare, typename Alloc>
+Set<T, Compare, Alloc> set_union(const Set<T, Compare, Alloc> &a, const Set<T, Compare, Alloc> &b) {
+	Compare comp = a.key_comp();
+	Vector<T> out;
+	out.reserve(a.size() + b.size());
+	auto i = a.begin();
+	auto j = b.begin();
+	while (i != a.end() && j != b.end()) {
+		if (comp(*i, *j))
+			out.push_back(*i++);
+		else if (comp(*j, *i))
+			out.push_back(*j++);
+		else {
+			out.push_back(*i++);
+			++j;
+		}
+	}
+	for (; i != a.end(); ++i)
+		out.push_back(*i);
+	for (; j != b.end(); ++j)
+		out.push_back(*j);
+	return Set<T, Compare, Alloc>(out.begin(), out.end(), comp, a.get_allocator());
+}
+
+template<typename T, typename Compare, typename Alloc>
+Set<T, Compare, Alloc> set_intersection(const Set<T, Compare, Alloc> &a, const Set<T, Compare, Alloc> &b) {
+	Compare comp = a.key_comp();
+	identity<T> keyOf;
+	Vector<T> out;
+	auto i = a.begin();
+	auto j = b.begin();
+	while (i != a.end() && j != b.end()) {
+		if (comp(*i, *j))
+			i = gallop_to(a, i, *j, keyOf, comp);
+		else if (comp(*j, *i))
+			j = gallop_to(b, j, *i, keyOf, comp);
+		else {
+			out.push_back(*i++);
+			++j;
+		}
+	}
+	return Set<T, Compare, Alloc>(out.begin(), out.end(), comp, a.get_allocator());
+}
+
+//elements of a that are not in b
+template<typename T, typename Compare, typename Alloc>
+Set<T, Compare, Alloc> set_difference(const Set<T, Compare, Alloc> &a, const Set<T, Compare, Alloc> &b) {
+	Compare comp = a.key_comp();
+	identity<T> keyOf;
+	Vector<T> out;
+	out.reserve(a.size());
+	auto i = a.begin();
+	auto j = b.begin();
+	while (i != a.end() && j != b.end()) {
+		if (comp(*i, *j))
+			out.push_back(*i++);
+		else if (comp(*j, *i))
+			j = gallop_to(b, j, *i, keyOf, comp);
+		else {
+			++i;
+			++j;
+		}
+	}
+	for (; i != a.end(); ++i)
+		out.push_back(*i);
+	return Set<T, Compare, Alloc>(out.begin(), out.end(), comp, a.get_allocator());
+}
+
+template<typename T, typename Compare, typename Alloc>
+Set<T, Compare, Alloc> set_symmetric_difference(const Set<T, Compare, Alloc> &a, const Set<T, Compare, Alloc> &b) {
+	Compare comp = a.key_comp();
+	Vector<T> out;
+	out.reserve(a.size() + b.size());
+	auto i = a.begin();
+	auto j = b.begin();
+	while (i != a.end() && j != b.end()) {
+		if (comp(*i, *j))
+			out.push_back(*i++);
+		else if (comp(*j, *i))
+			out.push_back(*j++);
+		else {
+			++i;
+			++j;
+		}
+	}
+	for (; i != a.end(); ++i)
+		out.push_back(*i);
+	for (; j != b.end(); ++j)
+		out.push_back(*j);
+	return Set<T, Compare, Alloc>(out.begin(), out.end(), comp, a.get_allocator());
+}
+
+//keys present in both maps, each with the pair of mapped values
+template<typename Key, typename A, typename B, typename Compare, typename AllocA, typename AllocB>
+Map<Key, std::pair<A, B>, Compare> map_join(const Map<Key, A, Compare, AllocA> &a, const Map<Key, B, Compare, AllocB> &b) {
+	Compare comp = a.key_comp();
+	select1st<const Key, A> keyOfA;
+	select1st<const Key, B> keyOfB;
+	Vector<std::pair<Key, std::pair<A, B>>> out;
+	auto i = a.begin();
+	auto j = b.begin();
+	while (i != a.end() && j != b.end()) {
+		if (comp(i->first, j->first))
+			i = gallop_to(a, i, j->first, keyOfA, comp);
+		else if (comp(j->first, i->first))
+			j = gallop_to(b, j, i->first, keyOfB, comp);
+		else {
+			out.push_back(std::make_pair(i->first, std::make_pair(i->second, j->second)));
+			++i;
+			++j;
+		}
+	}
+	return Map<Key, std::pair<A, B>, Compare>(out.begin(), out.end(), comp);
+}
+
+//entries of a whose key is not in b
+template<typename Key, typename A, typename B, typename Compare, typename AllocA, typename AllocB>
+Map<Key, A, Compare, AllocA> map_anti_join(const Map<Key, A, Compare, AllocA> &a, const Map<Key, B, Compare, AllocB> &b) {
+	Compare comp = a.key_comp();
+	select1st<const Key, B> keyOfB;
+	Vector<std::pair<Key, A>> out;
+	out.reserve(a.size());
+	auto i = a.begin();
+	auto j = b.begin();
+	while (i != a.end() && j != b.end()) {
+		if (comp(i->first, j->first))
+			out.push_back(*i++);
+		else if (comp(j->first, i->first))
+			j = gallop_to(b, j, i->first, keyOfB, comp);
+		else {
+			++i;
+			++j;
+		}
+	}
+	for (; i != a.end(); ++i)
+		out.push_back(*i);
+	return Map<Key, A, Compare, AllocA>(out.begin(), out.end(), comp, a.get_allocator());
+}
+
+#endif // !SETALGEBRA_H
\ No newline at end of file
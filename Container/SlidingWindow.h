@@ -0,0 +1,166 @@
+#ifndef SLIDINGWINDOW_H
+#define SLIDINGWINDOW_H
+#include<functional>
+#include"Deque.h"
+
+template<typename T, typename Compare = std::less<T>>
+class window_min {
+public:
+	typedef Compare compare_type;
+
+	T operator()(const T &lhs, const T &rhs)const {
+		return Compare()(rhs, lhs) ? rhs : lhs;
+	}
+};
+
+template<typename T, typename Compare = std::less<T>>
+class window_max {
+public:
+	typedef Compare compare_type;
+
+	T operator()(const T &lhs, const T &rhs)const {
+		return Compare()(lhs, rhs) ? rhs : lhs;
+	}
+};
+
+template<typename Time, typename T>
+struct window_entry {
+	Time _time;
+	T _value;
+	T _agg;
+
+	window_entry(const Time &time, const T &value) :_time(time), _value(value), _agg(value) {};
+};
+
+//Op must be associative, samples must be pushed with non-decreasing time.
+//Two stacks live in one Deque: [0, _split) keeps suffix aggregates towards _split, [_split, size()) is folded into _backAgg.
+template<typename T, typename Op = std::plus<T>, typename Time = long long>
+class SlidingWindow {
+public:
+	typedef T                        value_type;
+	typedef Op                       op_type;
+	typedef Time                     time_type;
+	typedef size_t                   size_type;
+	typedef window_entry<Time, T>    entry_type;
+	typedef Deque<entry_type>        container_type;
+private:
+	container_type _entries;
+	size_type _split;
+	value_type _backAgg;
+	op_type _op;
+public:
+	explicit SlidingWindow(const op_type &op = op_type()) :_split(0), _backAgg(), _op(op) {};
+
+	bool empty()const {
+		return _entries.empty();
+	}
+
+	size_type size()const {
+		return _entries.size();
+	}
+
+	void push(const time_type &time, const value_type &val) {
+		_backAgg = _split == _entries.size() ? val : _op(_backAgg, val);
+		_entries.push_back(entry_type(time, val));
+	}
+
+	void evict_older_than(const time_type &time) {
+		while (!_entries.empty() && _entries.front()._time < time) {
+			if (_split == 0)
+				_flip();
+			_entries.pop_front();
+			--_split;
+		}
+	}
+
+	value_type query()const {
+		if (empty())
+			throw std::exception("");
+		if (_split == 0)
+			return _backAgg;
+		if (_split == _entries.size())
+			return _entries.front()._agg;
+		return _op(_entries.front()._agg, _backAgg);
+	}
+
+	void clear() {
+		_entries.clear();
+		_split = 0;
+	}
+private:
+	void _flip() {
+		_split = _entries.size();
+		for (size_type i = _split - 1; i > 0; --i)
+			_entries[i - 1]._agg = _op(_entries[i - 1]._value, _entries[i]._agg);
+	}
+};
+
+//min/max only need the monotonic deque: an older sample that is not better than a newer one can never be the answer again.
+template<typename T, typename Time>
+class monotonic_window {
+public:
+	typedef T                        value_type;
+	typedef Time                     time_type;
+	typedef std::pair<Time, T>       entry_type;
+	typedef Deque<entry_type>        container_type;
+	typedef size_t                   size_type;
+private:
+	container_type _entries;
+public:
+	bool empty()const {
+		return _entries.empty();
+	}
+
+	//samples kept as candidates, which can be fewer than were pushed inside the window
+	size_type size()const {
+		return _entries.size();
+	}
+
+	template<typename Compare>
+	void push(const time_type &time, const value_type &val, Compare comp) {
+		while (!_entries.empty() && !comp(_entries.back().second, val))
+			_entries.pop_back();
+		_entries.push_back(entry_type(time, val));
+	}
+
+	void evict_older_than(const time_type &time) {
+		while (!_entries.empty() && _entries.front().first < time)
+			_entries.pop_front();
+	}
+
+	value_type query()const {
+		if (empty())
+			throw std::exception("");
+		return _entries.front().second;
+	}
+
+	void clear() {
+		_entries.clear();
+	}
+};
+
+template<typename T, typename Compare, typename Time>
+class SlidingWindow<T, window_min<T, Compare>, Time> :public monotonic_window<T, Time> {
+public:
+	typedef window_min<T, Compare> op_type;
+
+	explicit SlidingWindow(const op_type & = op_type()) {};
+
+	void push(const Time &time, const T &val) {
+		monotonic_window<T, Time>::push(time, val, Compare());
+	}
+};
+
+template<typename T, typename Compare, typename Time>
+class SlidingWindow<T, window_max<T, Compare>, Time> :public monotonic_window<T, Time> {
+public:
+	typedef window_max<T, Compare> op_type;
+
+	explicit SlidingWindow(const op_type & = op_type()) {};
+
+	void push(const Time &time, const T &val) {
+		monotonic_window<T, Time>::push(time, val, [](const T &lhs, const T &rhs)->bool {return Compare()(rhs, lhs); });
+	}
+};
+
+#endif // !SLIDINGWINDOW_H
\ No newline at end of file
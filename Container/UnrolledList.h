@@ -0,0 +1,535 @@
+#ifndef UNROLLEDLIST_H
+#define UNROLLEDLIST_H
+#include<memory>
+#include<initializer_list>
+#include<iterator>
+#include<type_traits>
+#include<utility>
+
+template<typename T, size_t K>
+struct unrolled_node {
+	unrolled_node *_next;
+	unrolled_node *_pre;
+	size_t _count;
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type _slots[K];
+
+	T* _data() {
+		return reinterpret_cast<T*>(_slots);
+	}
+};
+
+template<typename T, size_t K, typename Alloc = std::allocator<unrolled_node<T, K>>>
+class UnrolledList;
+
+template<typename T, size_t K>
+class unrolled_list_iterator {
+public:
+	typedef T                               value_type;
+	typedef ptrdiff_t                       difference_type;
+	typedef T&                              reference;
+	typedef T*                              pointer;
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef unrolled_node<T, K>*            link_type;
+	typedef size_t                          size_type;
+protected:
+	link_type _node;
+	size_type _index;
+	template<typename, size_t, typename> friend class UnrolledList;
+public:
+	unrolled_list_iterator() :_node(nullptr), _index(0) {};
+
+	unrolled_list_iterator(link_type node, size_type index) :_node(node), _index(index) {};
+
+	unrolled_list_iterator(const unrolled_list_iterator &x) :_node(x._node), _index(x._index) {};
+
+	unrolled_list_iterator& operator=(const unrolled_list_iterator &x) {
+		_node = x._node;
+		_index = x._index;
+		return *this;
+	}
+
+	bool operator==(const unrolled_list_iterator &x)const {
+		return _node == x._node && _index == x._index;
+	}
+
+	bool operator!=(const unrolled_list_iterator &x)const {
+		return !(*this == x);
+	}
+
+	reference operator*()const {
+		return _node->_data()[_index];
+	}
+
+	pointer operator->()const {
+		return _node->_data() + _index;
+	}
+
+	unrolled_list_iterator& operator++() {
+		if (++_index >= _node->_count) {
+			_node = _node->_next;
+			_index = 0;
+		}
+		return *this;
+	}
+
+	unrolled_list_iterator operator++(int) {
+		unrolled_list_iterator retIt(*this);
+		++*this;
+		return retIt;
+	}
+
+	unrolled_list_iterator& operator--() {
+		if (_index == 0) {
+			_node = _node->_pre;
+			_index = _node->_count - 1;
+		}
+		else
+			--_index;
+		return *this;
+	}
+
+	unrolled_list_iterator operator--(int) {
+		unrolled_list_iterator retIt(*this);
+		--*this;
+		return retIt;
+	}
+};
+
+template<typename T, size_t K>
+class const_unrolled_list_iterator :public unrolled_list_iterator<T, K> {
+	template<typename, size_t, typename> friend class UnrolledList;
+public:
+	typedef T                               value_type;
+	typedef ptrdiff_t                       difference_type;
+	typedef const T&                        reference;
+	typedef const T*                        pointer;
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef unrolled_node<T, K>*            link_type;
+	typedef unrolled_list_iterator<T, K>    parent_iterator;
+public:
+	const_unrolled_list_iterator() :parent_iterator() {};
+
+	const_unrolled_list_iterator(link_type node, size_t index) :parent_iterator(node, index) {};
+
+	const_unrolled_list_iterator(const parent_iterator &x) :parent_iterator(x) {};
+
+	reference operator*()const {
+		return this->_node->_data()[this->_index];
+	}
+
+	pointer operator->()const {
+		return this->_node->_data() + this->_index;
+	}
+
+	const_unrolled_list_iterator& operator++() {
+		parent_iterator::operator++();
+		return *this;
+	}
+
+	const_unrolled_list_iterator operator++(int) {
+		const_unrolled_list_iterator retIt(*this);
+		++*this;
+		return retIt;
+	}
+
+	const_unrolled_list_iterator& operator--() {
+		parent_iterator::operator--();
+		return *this;
+	}
+
+	const_unrolled_list_iterator operator--(int) {
+		const_unrolled_list_iterator retIt(*this);
+		--*this;
+		return retIt;
+	}
+};
+
+//Each node keeps up to K elements in place. Insert and erase only invalidate iterators into the nodes they touch,
+//a full node is split in half and a node that drops below K/2 is merged into its successor when they fit.
+template<typename T, size_t K, typename Alloc>
+class UnrolledList {
+	static_assert(K >= 2, "UnrolledList needs at least two elements per node");
+public:
+	typedef Alloc                                 allocator_type;
+	typedef size_t                                size_type;
+	typedef ptrdiff_t                             difference_type;
+	typedef T                                     value_type;
+	typedef T&                                    reference;
+	typedef const T&                              const_reference;
+	typedef unrolled_node<T, K>*                  link_type;
+	typedef T*                                    pointer;
+	typedef const T*                              const_pointer;
+	typedef unrolled_list_iterator<T, K>          iterator;
+	typedef const_unrolled_list_iterator<T, K>    const_iterator;
+	typedef std::reverse_iterator<iterator>       reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+private:
+	link_type _blankNode;
+	size_type _size;
+	allocator_type _alloc;
+public:
+	explicit UnrolledList(const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
+		_init_blanknode();
+	}
+
+	UnrolledList(size_type n, const value_type &val, const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
+		_init_blanknode();
+		_construct_aux(n, val, std::true_type());
+	}
+
+	template<typename InputIterator>
+	UnrolledList(InputIterator first, InputIterator last, const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
+		_init_blanknode();
+		_construct_aux(first, last, typename std::is_integral<InputIterator>::type());
+	}
+
+	UnrolledList(const UnrolledList &x) :_alloc(x._alloc) {
+		_init_blanknode();
+		for (const_iterator it = x.begin(); it != x.end(); ++it)
+			push_back(*it);
+	}
+
+	UnrolledList(std::initializer_list<value_type> il, const allocator_type &alloc = allocator_type()) :_alloc(alloc) {
+		_init_blanknode();
+		for (auto it = il.begin(); it != il.end(); ++it)
+			push_back(*it);
+	}
+
+	~UnrolledList() {
+		clear();
+		_alloc.deallocate(_blankNode, 1);
+	}
+
+	UnrolledList& operator=(const UnrolledList &x) {
+		if (this == &x)
+			return *this;
+		clear();
+		for (const_iterator it = x.begin(); it != x.end(); ++it)
+			push_back(*it);
+		return *this;
+	}
+
+	iterator begin() {
+		return iterator(_blankNode->_next, 0);
+	}
+
+	const_iterator begin()const {
+		return const_iterator(_blankNode->_next, 0);
+	}
+
+	iterator end() {
+		return iterator(_blankNode, 0);
+	}
+
+	const_iterator end()const {
+		return const_iterator(_blankNode, 0);
+	}
+
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin()const {
+		return const_reverse_iterator(end());
+	}
+
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend()const {
+		return const_reverse_iterator(begin());
+	}
+
+	const_iterator cbegin()const {
+		return begin();
+	}
+
+	const_iterator cend()const {
+		return end();
+	}
+
+	bool empty()const {
+		return _size == 0;
+	}
+
+	size_type size()const {
+		return _size;
+	}
+
+	reference front() {
+		if (empty())
+			throw std::exception("");
+		return *begin();
+	}
+
+	const_reference front()const {
+		if (empty())
+			throw std::exception("");
+		return *begin();
+	}
+
+	reference back() {
+		if (empty())
+			throw std::exception("");
+		return *(--end());
+	}
+
+	const_reference back()const {
+		if (empty())
+			throw std::exception("");
+		return *(--end());
+	}
+
+	void push_front(const value_type &val) {
+		insert(begin(), val);
+	}
+
+	void pop_front() {
+		erase(begin());
+	}
+
+	void push_back(const value_type &val) {
+		insert(end(), val);
+	}
+
+	void pop_back() {
+		erase(--end());
+	}
+
+	template <typename... Args>
+	void emplace_back(Args&&... args) {
+		insert(end(), value_type(std::forward<Args>(args)...));
+	}
+
+	iterator insert(const_iterator position, const value_type &val) {
+		link_type node = position._node;
+		size_type index = position._index;
+		//inserting in front of a node appends to its predecessor when there is room, so appends keep nodes full
+		if (index == 0 && node->_pre != _blankNode && node->_pre->_count < K) {
+			node = node->_pre;
+			index = node->_count;
+		}
+		else if (node == _blankNode) {
+			node = _new_node_after(_blankNode->_pre);
+			index = 0;
+		}
+		else if (node->_count == K) {
+			link_type upper = _new_node_after(node);
+			_move_slots(node, K / 2, K, upper, 0);
+			if (index > K / 2) {
+				index -= K / 2;
+				node = upper;
+			}
+		}
+		pointer data = node->_data();
+		if (index == node->_count)
+			::new((void*)(data + index)) value_type(val);
+		else {
+			value_type copy(val);
+			::new((void*)(data + node->_count)) value_type(std::move(data[node->_count - 1]));
+			std::move_backward(data + index, data + node->_count - 1, data + node->_count);
+			data[index] = std::move(copy);
+		}
+		++node->_count;
+		++_size;
+		return iterator(node, index);
+	}
+
+	template<typename InputIterator>
+	void insert(const_iterator position, InputIterator first, InputIterator last) {
+		while (first != last) {
+			position = insert(position, *first++);
+			++position;
+		}
+	}
+
+	iterator erase(const_iterator position) {
+		link_type node = position._node;
+		size_type index = position._index;
+		if (node == _blankNode)
+			throw std::exception("");
+		pointer data = node->_data();
+		std::move(data + index + 1, data + node->_count, data + index);
+		data[--node->_count].~value_type();
+		--_size;
+		if (node->_count == 0) {
+			link_type next = node->_next;
+			_free_node(node);
+			return iterator(next, 0);
+		}
+		if (node->_count < K / 2)
+			_try_merge(node);
+		if (index < node->_count)
+			return iterator(node, index);
+		return iterator(node->_next, 0);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		//erasing only shifts elements towards first, so last is tracked by its distance
+		difference_type n = std::distance(first, last);
+		iterator it(first);
+		while (n--)
+			it = erase(it);
+		return it;
+	}
+
+	void swap(UnrolledList &x) {
+		std::swap(_blankNode, x._blankNode);
+		std::swap(_size, x._size);
+		std::swap(_alloc, x._alloc);
+	}
+
+	void clear() noexcept {
+		link_type node = _blankNode->_next;
+		while (node != _blankNode) {
+			link_type next = node->_next;
+			_destroy_slots(node, 0, node->_count);
+			_alloc.deallocate(node, 1);
+			node = next;
+		}
+		_blankNode->_next = _blankNode;
+		_blankNode->_pre = _blankNode;
+		_size = 0;
+	}
+
+	//whole nodes are relinked, only the nodes holding position, first and last are split
+	void splice(const_iterator position, UnrolledList &x) {
+		if (this == &x || x.empty())
+			return;
+		splice(position, x, x.begin(), x.end());
+	}
+
+	void splice(const_iterator position, UnrolledList &x, const_iterator i) {
+		const_iterator iNext(i);
+		++iNext;
+		splice(position, x, i, iNext);
+	}
+
+	void splice(const_iterator position, UnrolledList &x, const_iterator first, const_iterator last) {
+		if (first == last || position == first || position == last)
+			return;
+		iterator pos(position), from(first), to(last);
+		link_type toNode = x._split(to, from, pos);
+		link_type fromNode = x._split(from, to, pos);
+		link_type posNode = _split(pos, from, to);
+		if (this != &x) {
+			size_type n = 0;
+			for (link_type node = fromNode; node != toNode; node = node->_next)
+				n += node->_count;
+			x._size -= n;
+			_size += n;
+		}
+		link_type beforeFrom = fromNode->_pre;
+		link_type lastNode = toNode->_pre;
+		beforeFrom->_next = toNode;
+		toNode->_pre = beforeFrom;
+		fromNode->_pre = posNode->_pre;
+		posNode->_pre->_next = fromNode;
+		lastNode->_next = posNode;
+		posNode->_pre = lastNode;
+		x._try_merge(beforeFrom);
+		_try_merge(lastNode);
+		_try_merge(fromNode->_pre);
+	}
+
+	void remove(const value_type &val) {
+		remove_if([&val](const value_type &v)->bool {return val == v; });
+	}
+
+	template<typename Predicate>
+	void remove_if(Predicate pred) {
+		iterator it = begin();
+		while (it != end()) {
+			if (pred(*it))
+				it = erase(it);
+			else
+				++it;
+		}
+	}
+
+	allocator_type get_allocator()const {
+		return _alloc;
+	}
+private:
+	void _init_blanknode() {
+		_blankNode = _alloc.allocate(1);
+		_blankNode->_next = _blankNode;
+		_blankNode->_pre = _blankNode;
+		_blankNode->_count = 0;
+		_size = 0;
+	}
+
+	void _construct_aux(size_type n, const value_type &val, std::true_type) {
+		while (n--)
+			push_back(val);
+	}
+
+	template<typename InputIterator>
+	void _construct_aux(InputIterator first, InputIterator last, std::false_type) {
+		while (first != last)
+			push_back(*first++);
+	}
+
+	link_type _new_node_after(link_type pre) {
+		link_type node = _alloc.allocate(1);
+		node->_count = 0;
+		node->_pre = pre;
+		node->_next = pre->_next;
+		pre->_next->_pre = node;
+		pre->_next = node;
+		return node;
+	}
+
+	void _free_node(link_type node) {
+		node->_pre->_next = node->_next;
+		node->_next->_pre = node->_pre;
+		_alloc.deallocate(node, 1);
+	}
+
+	//moves src[first, last) into the raw slots dst[at, ...), src gives up the tail it loses
+	void _move_slots(link_type src, size_type first, size_type last, link_type dst, size_type at) {
+		pointer from = src->_data();
+		pointer to = dst->_data() + at;
+		for (size_type i = first; i != last; ++i, ++to) {
+			::new((void*)to) value_type(std::move(from[i]));
+			from[i].~value_type();
+		}
+		src->_count -= last - first;
+		dst->_count += last - first;
+	}
+
+	void _destroy_slots(link_type node, size_type first, size_type last) {
+		if (!std::is_trivially_destructible<value_type>::value) {
+			pointer data = node->_data();
+			for (size_type i = first; i != last; ++i)
+				data[i].~value_type();
+		}
+	}
+
+	//makes it point at the first slot of a node; a and b are fixed up if they lived in the moved tail
+	link_type _split(iterator &it, iterator &a, iterator &b) {
+		link_type node = it._node;
+		size_type index = it._index;
+		if (index == 0)
+			return node;
+		link_type upper = _new_node_after(node);
+		_move_slots(node, index, node->_count, upper, 0);
+		if (a._node == node && a._index >= index)
+			a = iterator(upper, a._index - index);
+		if (b._node == node && b._index >= index)
+			b = iterator(upper, b._index - index);
+		it = iterator(upper, 0);
+		return upper;
+	}
+
+	void _try_merge(link_type node) {
+		link_type next = node->_next;
+		if (node == _blankNode || next == _blankNode || node->_count + next->_count > K)
+			return;
+		_move_slots(next, 0, next->_count, node, node->_count);
+		_free_node(next);
+	}
+};
+
+#endif // !UNROLLEDLIST_H
\ No newline at end of file